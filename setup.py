@@ -28,7 +28,26 @@ write_version_py()
 
 ext_modules = [Extension("simncad.ncad",
                         ["./simncad/c_ncad.pxd", "./simncad/ncad.pyx",
-                         "./simncad/src/error_handlers.cpp"],
+                         "./simncad/src/error_handlers.cpp",
+                         "./simncad/src/TaskPool.cpp",
+                         "./simncad/src/NeighbourSearch.cpp",
+                         "./simncad/src/Autobond.cpp",
+                         "./simncad/src/Symbols.cpp",
+                         "./simncad/src/AtomStore.cpp",
+                         "./simncad/src/AssemblyAtoms.cpp",
+                         "./simncad/src/BondStore.cpp",
+                         "./simncad/src/BatchActions.cpp",
+                         "./simncad/src/AtomGrid.cpp",
+                         "./simncad/src/Cursors.cpp",
+                         "./simncad/src/SpatialOrder.cpp",
+                         "./simncad/src/Uuid.cpp",
+                         "./simncad/src/ParticleIndex.cpp",
+                         "./simncad/src/IdIndex.cpp",
+                         "./simncad/src/AssemblyArrays.cpp",
+                         "./simncad/src/AsyncJob.cpp",
+                         "./simncad/src/AssemblyBonds.cpp",
+                         "./simncad/src/Sha1.cpp",
+                         "./simncad/src/AtomUuids.cpp"],
                         include_dirs = [ncad_include_path, simphony_include_path, "./simncad"],
                         language='c++',
                         extra_objects=["C:\NCad\libNCad.dll"])]
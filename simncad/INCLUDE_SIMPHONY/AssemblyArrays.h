@@ -0,0 +1,99 @@
+#ifndef __ASSEMBLY_ARRAYS__H__
+#define __ASSEMBLY_ARRAYS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "AtomStore.h"
+#include "AtomGrid.h"
+#include "BondStore.h"
+#include "Symbols.h"
+#include "SpatialOrder.h"
+using namespace std;
+
+class CAssemblyArrays
+/**Snapshot of the processed assembly as flat arrays, one item per atom or bond, owned
+by the object and exposed to Python as NumPy arrays without copies.
+
+The coordinates are kept as an n x 3 array, the species, labels and components as
+small codes into dictionaries of names (numbered from 0 in the order of appearance), and
+each bond as the indexes of its two atoms in the arrays, the lower first. The arrays are
+only valid until the next Load or Clear. The atoms inside a region are found with a grid
+built by the first query.*/
+{
+public:
+    CAssemblyArrays() : grid(atoms) {}
+
+    /**Reads the atoms and bonds of the processed assembly.
+    @param Wrapper the nCad wrapper with the processed assembly.
+    @param order the order of the atoms.
+    @param workers number of worker threads to sort the atoms, 0 means one per processor.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR Load(const NC_Wrapper &Wrapper, SpatialOrderType order, DWORD workers = 0);
+    /**Removes all the atoms, bonds and names.*/
+    void Clear();
+
+    /**Returns the number of atoms.*/
+    DWORD GetNAtoms() const { return atoms.GetSize(); }
+    /**Returns the number of bonds.*/
+    DWORD GetNBonds() const { return bondAtoms.size() / 2; }
+
+    /**Returns the IDs of the atoms, or NULL if there are no atoms.*/
+    const id_t * GetIDs() const { return GetData(atoms.GetIDs()); }
+    /**Returns the x, y and z coordinates of each atom, one after the other.*/
+    const double * GetCoordinates() const { return GetData(coordinates); }
+    /**Returns the index in GetSpeciesNames of the species of each atom.*/
+    const WORD * GetSpecies() const { return GetData(species); }
+    /**Returns the index in GetLabelNames of the label of each atom.*/
+    const DWORD * GetLabels() const { return GetData(atoms.GetLabelIndexes()); }
+    /**Returns the occupancy of each atom.*/
+    const double * GetOccupancies() const { return GetData(atoms.GetOccupancies()); }
+    /**Returns the index in GetComponentNames of the component of each atom.*/
+    const DWORD * GetComponents() const { return GetData(components); }
+    /**Returns the indexes of the two atoms of each bond, one after the other.*/
+    const DWORD * GetBondAtoms() const { return GetData(bondAtoms); }
+
+    /**Returns the dictionary of the species.*/
+    const CSymbolTable & GetSpeciesNames() const { return speciesNames; }
+    /**Returns the dictionary of the labels.*/
+    const CSymbolTable & GetLabelNames() const { return atoms.GetLabelNames(); }
+    /**Returns the dictionary of the component names.*/
+    const CSymbolTable & GetComponentNames() const { return componentNames; }
+
+    /**Finds the atoms inside a box, including its faces.
+    @param lower the x, y and z of the lower corner of the box.
+    @param upper the x, y and z of the upper corner of the box.
+    @param indexes vector where the indexes of the atoms are appended, in ascending order.*/
+    void FindInBox(const double *lower, const double *upper, vector<DWORD> &indexes) const;
+    /**Finds the atoms inside a sphere, including its surface.
+    @param center the x, y and z of the center of the sphere.
+    @param radius the radius of the sphere.
+    @param indexes vector where the indexes of the atoms are appended, in ascending order.*/
+    void FindInRadius(const double *center, double radius, vector<DWORD> &indexes) const;
+
+private:
+    CAtomStore atoms;
+    vector<double> coordinates;
+    vector<WORD> species;
+    vector<DWORD> components;
+    vector<DWORD> bondAtoms;
+    CSymbolTable speciesNames;
+    CSymbolTable componentNames;
+    /**Grid over the atoms, built by the first query after Load.*/
+    CAtomGrid grid;
+
+    /**Fills the arrays of the atoms from the store.*/
+    void IndexAtoms(const NC_Wrapper &Wrapper);
+    /**Fills the atoms of the bonds from their adjacency lists.*/
+    void IndexBonds(const CBondStore &bonds);
+
+    // Not copyable, the grid refers to the atoms
+    CAssemblyArrays(const CAssemblyArrays &);
+    CAssemblyArrays & operator=(const CAssemblyArrays &);
+
+    template <class T>
+    static const T * GetData(const vector<T> &items) { return items.empty() ? NULL : &items[0]; }
+};
+
+#endif /*__ASSEMBLY_ARRAYS__H__*/
@@ -0,0 +1,48 @@
+#ifndef __ASSEMBLY_BONDS__H__
+#define __ASSEMBLY_BONDS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "IdIndex.h"
+using namespace std;
+
+class CAssemblyBondArrays
+/**Bonds of the processed assembly with both atoms resolved to their Simphony UUIDs, as
+arrays of 16 bytes per bond (the order of uuid.UUID.bytes) to be read from Python in a
+single transfer.
+
+The IDs of the atoms are read from nCad first, and then looked up in the CIdIndex of the
+assembly atoms in parallel ranges, since the index is only read.*/
+{
+public:
+    /**Reads the bonds of the processed assembly and resolves their atoms.
+    @param Wrapper the nCad wrapper with the processed assembly.
+    @param AtomUuids the UUIDs of the assembly atoms, by their IDs.
+    @param workers number of worker threads, 0 means one per processor.
+    @returns NULL in case of success or pointer to the error string in case of failure
+    (e.g. a bond with an atom that is not in the index).*/
+    ERR Load(const NC_Wrapper &Wrapper, const CIdIndex &AtomUuids, DWORD workers = 0);
+    /**Removes all the bonds.*/
+    void Clear();
+
+    /**Returns the number of bonds.*/
+    DWORD GetSize() const { return ids1.size(); }
+    /**Returns the IDs of the first atoms, or NULL if there are no bonds.*/
+    const id_t * GetIDs1() const { return ids1.empty() ? NULL : &ids1[0]; }
+    /**Returns the IDs of the second atoms, or NULL if there are no bonds.*/
+    const id_t * GetIDs2() const { return ids2.empty() ? NULL : &ids2[0]; }
+    /**Returns the 16 bytes UUIDs of the first atoms, one after the other.*/
+    const BYTE * GetUuids1() const { return uuids1.empty() ? NULL : &uuids1[0]; }
+    /**Returns the 16 bytes UUIDs of the second atoms, one after the other.*/
+    const BYTE * GetUuids2() const { return uuids2.empty() ? NULL : &uuids2[0]; }
+
+private:
+    vector<id_t> ids1;
+    vector<id_t> ids2;
+    vector<BYTE> uuids1;
+    vector<BYTE> uuids2;
+};
+
+#endif /*__ASSEMBLY_BONDS__H__*/
@@ -0,0 +1,108 @@
+#ifndef __ASYNC_JOB__H__
+#define __ASYNC_JOB__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <string>
+#include "WRAPPER/NC_Wrapper.h"
+#include "IdIndex.h"
+#include "AssemblyBonds.h"
+using namespace std;
+
+class CNCadSimphony;
+class CNCadParticleContainer;
+
+class CAsyncJob
+/**Long operation of nCad run on a worker thread, so the thread that starts it (e.g. the
+Python interpreter, with the GIL released) is free until it waits for the end. The
+exceptions of the operation are caught on the worker thread and kept as the error of
+the job, so waiting never throws.*/
+{
+public:
+    /**Destructor. Waits for the end of the operation.*/
+    virtual ~CAsyncJob();
+
+    /**Starts the operation on the worker thread. A job is started once.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR Start();
+    /**Returns TRUE if the operation ended, without waiting.*/
+    BOOL IsDone() const;
+    /**Waits for the end of the operation.
+    @param milliseconds the longest time to wait, INFINITE to wait for the end.
+    @returns TRUE if the operation ended.*/
+    BOOL Wait(DWORD milliseconds = INFINITE) const;
+    /**Returns the error of the operation, which is NULL before the end or in case of success.*/
+    ERR GetError() const { return IsDone() ? result : NULL; }
+
+protected:
+    /**Constructor.*/
+    CAsyncJob() : thread(NULL), result(NULL) {}
+    /**Runs the operation on the worker thread, which may throw runtime_error.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    virtual ERR Run() = 0;
+
+private:
+    HANDLE thread;
+    ERR result;
+    /**Message of an exception of Run.*/
+    string error;
+
+    /**Thread entry point.*/
+    static DWORD WINAPI JobProc(LPVOID pParam);
+
+    // Not copyable, the thread is owned
+    CAsyncJob(const CAsyncJob &);
+    CAsyncJob & operator=(const CAsyncJob &);
+};
+
+//==============================================================================
+class CAssemblyJob : public CAsyncJob
+/**Processing of all the components in the assembly, as ProcessAll, followed by the
+bonding of the assembly atoms and the reading of the atoms, as BeginAssembly and
+GetAssemblyAtoms.*/
+{
+public:
+    /**Constructor.
+    @param aNCad the adapter, which must not be used by others until the end of the job.
+    @param aWorkers number of worker threads of the bonding, 0 means one per processor.
+    @param aBondMaxLength if positive, the assembly atoms closer than this distance are bonded.
+    @param aAssembly the container where the atoms are read, or NULL to only process.*/
+    CAssemblyJob(CNCadSimphony &aNCad, DWORD aWorkers, double aBondMaxLength, CNCadParticleContainer *aAssembly)
+        : ncad(aNCad), workers(aWorkers), bondMaxLength(aBondMaxLength), pAssembly(aAssembly) {}
+    /**Destructor.*/
+    ~CAssemblyJob();
+
+protected:
+    ERR Run();
+
+private:
+    CNCadSimphony &ncad;
+    DWORD workers;
+    double bondMaxLength;
+    CNCadParticleContainer *pAssembly;
+};
+
+class CAssemblyBondsJob : public CAsyncJob
+/**Reading of the bonds of the processed assembly to a CAssemblyBondArrays, once its atoms
+were given their Simphony IDs.*/
+{
+public:
+    /**Constructor.
+    @param aAtomUuids the UUIDs of the assembly atoms, by their IDs.
+    @param aBonds the arrays where the bonds are read.
+    @param aWorkers number of worker threads, 0 means one per processor.*/
+    CAssemblyBondsJob(const CIdIndex &aAtomUuids, CAssemblyBondArrays &aBonds, DWORD aWorkers)
+        : AtomUuids(aAtomUuids), bonds(aBonds), workers(aWorkers) {}
+    /**Destructor.*/
+    ~CAssemblyBondsJob();
+
+protected:
+    ERR Run();
+
+private:
+    const CIdIndex &AtomUuids;
+    CAssemblyBondArrays &bonds;
+    DWORD workers;
+};
+
+#endif /*__ASYNC_JOB__H__*/
@@ -0,0 +1,76 @@
+#ifndef __ATOM_GRID__H__
+#define __ATOM_GRID__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "AtomStore.h"
+using namespace std;
+
+/**Average number of atoms per bin of a CAtomGrid.*/
+#define ATOM_GRID_DENSITY 4
+
+class CAtomGrid
+/**Uniform grid of bins over the atoms of a CAtomStore to find the atoms inside a box or
+a sphere without scanning all of them.
+
+The atoms are binned by counting sort (the bins are compressed sparse rows of atom
+indexes), with a copy of their coordinates in bin order so each bin is read from
+contiguous memory. The bins fully inside the region are taken without testing their
+atoms. The grid is built by the first query, or by Build, and must be built again or
+invalidated if the store is modified. The queries can be run by several threads once it
+is built.*/
+{
+public:
+    /**Constructor.
+    @param aStore the atoms, which must be kept while the grid is used.*/
+    CAtomGrid(const CAtomStore &aStore) : store(aStore), built(FALSE), binSize(0)
+    {
+        dims[0] = dims[1] = dims[2] = 0;
+    }
+
+    /**Bins the atoms of the store.*/
+    void Build();
+    /**Marks the grid to be built again by the next query, after the store is modified.*/
+    void Invalidate() { built = FALSE; }
+
+    /**Finds the atoms inside a box, including its faces.
+    @param Box the box.
+    @param indexes vector where the indexes of the atoms are appended, in ascending order.*/
+    void FindInBox(const Vector3DBox &Box, vector<DWORD> &indexes) const;
+    /**Finds the atoms inside a sphere, including its surface.
+    @param Center the center of the sphere.
+    @param radius the radius of the sphere.
+    @param indexes vector where the indexes of the atoms are appended, in ascending order.*/
+    void FindInRadius(const Vector3D &Center, double radius, vector<DWORD> &indexes) const;
+
+private:
+    const CAtomStore &store;
+    /**The grid is built (the queries build it when needed, so it is mutable).*/
+    mutable BOOL built;
+    /**Index in order of the first atom of each bin, plus the end.*/
+    mutable vector<DWORD> binStart;
+    /**Indexes of the atoms sorted by bin.*/
+    mutable vector<DWORD> order;
+    /**Coordinates of the atoms sorted by bin.*/
+    mutable CPointArray binned;
+    /**Lower corner of the grid.*/
+    mutable Vector3D gridMin;
+    /**Edge of the bins.*/
+    mutable double binSize;
+    /**Number of bins along x, y and z.*/
+    mutable long dims[3];
+
+    /**Builds the grid if it was not built yet.*/
+    void BuildIfNeeded() const;
+    /**Returns the range of bins along each axis that overlaps the box between two corners.
+    @returns FALSE if the box is outside the grid.*/
+    BOOL GetBinRange(const Vector3D &Min, const Vector3D &Max, long from[3], long to[3]) const;
+
+    // Not copyable, it refers to the store
+    CAtomGrid(const CAtomGrid &);
+    CAtomGrid & operator=(const CAtomGrid &);
+};
+
+#endif /*__ATOM_GRID__H__*/
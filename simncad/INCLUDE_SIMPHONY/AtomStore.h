@@ -0,0 +1,150 @@
+#ifndef __ATOM_STORE__H__
+#define __ATOM_STORE__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include <string>
+#include "WRAPPER/NC_Wrapper.h"
+#include "Symbols.h"
+using namespace std;
+
+class CPointArray
+/**Points stored as separate arrays of x, y and z coordinates (structure of arrays).*/
+{
+public:
+    /**Coordinates of the points.*/
+    vector<double> x;
+    vector<double> y;
+    vector<double> z;
+
+    /**Returns the number of points.*/
+    DWORD GetSize() const { return x.size(); }
+    /**Changes the number of points.*/
+    void Resize(DWORD n) { x.resize(n); y.resize(n); z.resize(n); }
+    /**Removes all the points.*/
+    void Clear() { x.clear(); y.clear(); z.clear(); }
+    /**Appends a point.*/
+    void Add(const Vector3D &p) { x.push_back(p.x); y.push_back(p.y); z.push_back(p.z); }
+    /**Sets the point i.*/
+    void Set(DWORD i, const Vector3D &p) { x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+    /**Returns the point i.*/
+    Vector3D Get(DWORD i) const { return Vector3D(x[i], y[i], z[i]); }
+};
+
+class CAtomStore
+/**Atoms stored as separate arrays of IDs, coordinates, element, label and occupancy
+(structure of arrays) instead of one NC_Atom object per atom.
+
+The element names and labels repeat a lot (a component only has the ones of its unit
+cell), so they are interned: each atom keeps a small code instead of a string. The
+element code is the ElementNumber when the species is written as the element symbol,
+and the other species (charged ions, other spellings, pseudo atoms) take the codes
+from elementMAX on, in a dictionary of the store. The labels are kept in a CSymbolTable.
+So the atoms of an element are found comparing integers, and an atom takes about 46
+bytes and no allocation of its own. The loops over a single property (e.g. the
+coordinates, as a CPointArray) read contiguous memory.*/
+{
+public:
+    /**Returns the number of atoms.*/
+    DWORD GetSize() const { return ids.size(); }
+    /**Reserves memory for a number of atoms.*/
+    void Reserve(DWORD n);
+    /**Removes all the atoms and the names.*/
+    void Clear();
+    /**Removes all the atoms, keeping the names so the codes remain valid.*/
+    void ClearAtoms();
+
+    /**Changes the order of the atoms.
+    @param order the index of the atom to put at each position, a permutation of all the atoms.*/
+    void Reorder(const vector<DWORD> &order);
+
+    /**Returns the code of an element name, adding it to the dictionary if needed.*/
+    WORD InternElement(const string &element);
+    /**Returns the index of a label in the dictionary, adding it if needed.*/
+    DWORD InternLabel(const string &label) { return labelNames.Intern(label); }
+
+    /**Appends an atom.
+    @param id identification number of the atom.
+    @param Point Cartesian coordinates.
+    @param element code of the element name, as returned by InternElement.
+    @param label index of the label, as returned by InternLabel.
+    @param occupancy occupancy of the atom.*/
+    void Add(id_t id, const Vector3D &Point, WORD element, DWORD label, double occupancy)
+    {
+        ids.push_back(id);
+        xyz.Add(Point);
+        elements.push_back(element);
+        labels.push_back(label);
+        occupancies.push_back(occupancy);
+    }
+    /**Appends a copy of a NC_Atom.*/
+    void Add(const NC_Atom &Atom);
+
+    /**Returns the identification number of the atom i.*/
+    id_t GetID(DWORD i) const { return ids[i]; }
+    /**Returns the Cartesian coordinates of the atom i.*/
+    Vector3D GetXYZ(DWORD i) const { return xyz.Get(i); }
+    /**Returns the code of the element name of the atom i.*/
+    WORD GetElementCode(DWORD i) const { return elements[i]; }
+    /**Returns the element of the atom i, also for the species not written as the symbol.*/
+    ElementNumber GetElementNumber(DWORD i) const
+    {
+        WORD code = elements[i];
+        return code < elementMAX ? (ElementNumber)code : speciesElements[code - elementMAX];
+    }
+    /**Returns the index of the label of the atom i.*/
+    DWORD GetLabelIndex(DWORD i) const { return labels[i]; }
+    /**Returns the element name of the atom i.*/
+    const string & GetElement(DWORD i) const
+    {
+        WORD code = elements[i];
+        return code < elementMAX ? GetElementSymbol((ElementNumber)code) : speciesNames.GetName(code - elementMAX);
+    }
+    /**Returns the label of the atom i.*/
+    const string & GetLabel(DWORD i) const { return labelNames.GetName(labels[i]); }
+    /**Returns the occupancy of the atom i.*/
+    double GetOccupancy(DWORD i) const { return occupancies[i]; }
+
+    /**Returns the identification numbers of all the atoms.*/
+    const vector<id_t> & GetIDs() const { return ids; }
+    /**Returns the Cartesian coordinates of all the atoms.*/
+    const CPointArray & GetPoints() const { return xyz; }
+    /**Returns the codes of the element names of all the atoms.*/
+    const vector<WORD> & GetElementCodes() const { return elements; }
+    /**Returns the indexes of the labels of all the atoms.*/
+    const vector<DWORD> & GetLabelIndexes() const { return labels; }
+    /**Returns the occupancies of all the atoms.*/
+    const vector<double> & GetOccupancies() const { return occupancies; }
+    /**Returns the dictionary of labels.*/
+    const CSymbolTable & GetLabelNames() const { return labelNames; }
+
+private:
+    vector<id_t> ids;
+    CPointArray xyz;
+    vector<WORD> elements;
+    vector<DWORD> labels;
+    vector<double> occupancies;
+
+    /**Species that are not written as an element symbol, and their elements.*/
+    CSymbolTable speciesNames;
+    vector<ElementNumber> speciesElements;
+    CSymbolTable labelNames;
+};
+
+class CAtomStoreCollector : public NC_AtomAction
+/**Action to copy the iterated atoms to a CAtomStore.*/
+{
+    CAtomStore &store;
+public:
+    /**Constructor.
+    @param aStore the store where the atoms are appended.*/
+    CAtomStoreCollector(CAtomStore &aStore) : store(aStore) {}
+    ERR DoAction(const NC_Atom &Atom)
+    {
+        store.Add(Atom);
+        return NULL;
+    }
+};
+
+#endif /*__ATOM_STORE__H__*/
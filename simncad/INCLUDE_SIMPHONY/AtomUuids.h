@@ -0,0 +1,44 @@
+#ifndef __ATOM_UUIDS__H__
+#define __ATOM_UUIDS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include "WRAPPER/NC_Wrapper.h"
+#include "Uuid.h"
+using namespace std;
+
+/**Number of bytes of the name of an atom: its component ID and its AtomID.*/
+#define ATOM_NAME_BYTES 12
+
+/**Makes the name based UUIDs of the atoms of the processed assembly, in parallel ranges.
+The name of an atom is its component ID (4 bytes) followed by its AtomID (8 bytes), both
+big endian, so the UUID of an atom is uuid.uuid5(namespace, struct.pack('>iQ', component,
+id)) and the same assembly always gets the same UUIDs in the same namespace.
+@param Wrapper the nCad wrapper with the processed assembly.
+@param Namespace the 16 bytes UUID of the namespace (e.g. of the session).
+@param n number of atoms.
+@param ids the AtomIDs.
+@param uuids the 16 bytes of the UUID of each atom, in the order of uuid.UUID.bytes.
+@param workers number of worker threads, 0 means one per processor.
+@returns NULL in case of success or pointer to the error string in case of failure.*/
+ERR MakeAtomUuids(const NC_Wrapper &Wrapper, const BYTE *Namespace, DWORD n, const id_t *ids,
+    BYTE *uuids, DWORD workers = 0);
+
+/**Number of bytes of the name of a bond: the UUIDs of its two atoms.*/
+#define BOND_NAME_BYTES 32
+
+/**Makes the name based UUIDs of bonds from the UUIDs of their atoms, in parallel ranges.
+The name of a bond is the 16 bytes of the UUID of each atom, the lower first, so the UUID of
+a bond is uuid.uuid5(namespace, min(uuid1.bytes, uuid2.bytes) + max(uuid1.bytes,
+uuid2.bytes)), whichever of its atoms is given first.
+@param Namespace the 16 bytes UUID of the namespace.
+@param n number of bonds.
+@param uuids1 the 16 bytes of the UUID of the first atom of each bond.
+@param uuids2 the 16 bytes of the UUID of the second atom of each bond.
+@param uuids the 16 bytes of the UUID of each bond, in the order of uuid.UUID.bytes.
+@param workers number of worker threads, 0 means one per processor.
+@returns NULL in case of success or pointer to the error string in case of failure.*/
+ERR MakeBondUuids(const BYTE *Namespace, DWORD n, const BYTE *uuids1, const BYTE *uuids2, BYTE *uuids,
+    DWORD workers = 0);
+
+#endif /*__ATOM_UUIDS__H__*/
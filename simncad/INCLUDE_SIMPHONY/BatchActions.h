@@ -0,0 +1,60 @@
+#ifndef __BATCH_ACTIONS__H__
+#define __BATCH_ACTIONS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "AtomStore.h"
+using namespace std;
+
+/**Default number of atoms or bonds of the spans.*/
+#define BATCH_SIZE 4096
+
+/**Contiguous block of atoms of a CAtomStore, as arrays of their properties. The atom i
+of the block is the atom first + i of the store, which gives the names of the element
+codes and label indexes.*/
+typedef struct {
+    /**Store of the atoms.*/
+    const CAtomStore *pStore;
+    /**Index in the store of the first atom.*/
+    DWORD first;
+    /**Number of atoms.*/
+    DWORD count;
+    /**Identification numbers.*/
+    const id_t *ids;
+    /**Cartesian coordinates.*/
+    const double *x;
+    const double *y;
+    const double *z;
+    /**Codes of the element names.*/
+    const WORD *elements;
+    /**Indexes of the labels.*/
+    const DWORD *labels;
+    /**Occupancies.*/
+    const double *occupancies;
+} NC_AtomSpan;
+
+/**Contiguous block of bonds, as arrays of the IDs of their atoms and the indexes of
+their parameters in a table.*/
+typedef struct {
+    /**Number of bonds.*/
+    DWORD count;
+    /**IDs of the first and the second atoms.*/
+    const id_t *ids1;
+    const id_t *ids2;
+    /**Indexes of the parameters of the bonds in pParameters.*/
+    const WORD *params;
+    /**Table of the parameters.*/
+    const BondParameters *pParameters;
+} NC_BondSpan;
+
+//==============================================================================
+/**Points a span to a range of atoms of a store.
+@param store the atoms.
+@param first index of the first atom of the span.
+@param count number of atoms of the span.
+@param Atoms the span.*/
+void GetAtomSpan(const CAtomStore &store, DWORD first, DWORD count, NC_AtomSpan &Atoms);
+
+#endif /*__BATCH_ACTIONS__H__*/
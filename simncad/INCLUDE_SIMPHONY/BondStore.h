@@ -0,0 +1,121 @@
+#ifndef __BOND_STORE__H__
+#define __BOND_STORE__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "AtomStore.h"
+using namespace std;
+
+/**Index returned by CBondStore::GetAtomIndex for the atoms not in the store.*/
+#define ATOM_NONE ((DWORD)-1)
+
+class CBondStore
+/**Bonds between the atoms of a CAtomStore, as the adjacency lists of the atoms in
+compressed sparse row form, instead of one NC_Bond object per bond.
+
+The neighbours of the atom i are neighbours[rowStart[i]] to neighbours[rowStart[i + 1] - 1],
+sorted, and every bond is in the lists of both atoms (a bond of an atom with itself only
+once), so the bonds of an atom are found in O(degree). The parameters of the bonds are all alike, so
+each entry only keeps the index of its parameters in a table without repetitions. A bond
+takes 12 bytes, against the NC_Bond object, its allocation and the pointer to it.
+
+The bonds are first added by the IDs of their atoms and then indexed all at once by Build.
+Adding a bond twice keeps the parameters of the last one, as NC_Component::SetBond.*/
+{
+public:
+    /**Adds a bond, which is not found until Build is called.
+    @param id1 ID of the first atom.
+    @param id2 ID of the second atom.
+    @param Params parameters of the bond.*/
+    void Add(id_t id1, id_t id2, const BondParameters &Params);
+    /**Adds a copy of a NC_Bond of a component or the assembly.*/
+    void Add(const NC_Bond &Bond) { Add(Bond.ID1, Bond.ID2, Bond.BondParams); }
+
+    /**Indexes the added bonds (and the ones of a previous Build) over the atoms of a store,
+    which must not be modified while the bonds are used.
+    @param atoms the atoms of the bonds.
+    @returns NULL in case of success or pointer to the error string in case of failure
+    (e.g. a bond with an atom that is not in the store).*/
+    ERR Build(const CAtomStore &atoms);
+    /**Remaps the bonds after the atoms of the store were reordered by CAtomStore::Reorder,
+    without looking up their IDs again.
+    @param order the order given to CAtomStore::Reorder.*/
+    void Reorder(const vector<DWORD> &order);
+    /**Removes all the bonds.*/
+    void Clear();
+
+    /**Returns the number of bonds.*/
+    DWORD GetNBonds() const { return nBonds; }
+    /**Returns the number of atoms indexed by Build.*/
+    DWORD GetNAtoms() const { return rowStart.empty() ? 0 : rowStart.size() - 1; }
+    /**Returns the number of bonds of the atom i.*/
+    DWORD GetDegree(DWORD i) const { return rowStart[i + 1] - rowStart[i]; }
+    /**Returns the index of the n-th neighbour of the atom i.*/
+    DWORD GetNeighbour(DWORD i, DWORD n) const { return neighbours[rowStart[i] + n]; }
+    /**Returns the index in parameters of the bond with the n-th neighbour of the atom i.*/
+    WORD GetNeighbourParams(DWORD i, DWORD n) const { return neighbourParams[rowStart[i] + n]; }
+    /**Returns the ID of the atom i.*/
+    id_t GetAtomID(DWORD i) const { return atomIDs[i]; }
+
+    /**Returns the index in the store of an atom.
+    @param id the ID of the atom.
+    @returns the index or ATOM_NONE if the atom is not in the store.*/
+    DWORD GetAtomIndex(id_t id) const;
+
+    /**Returns the table of the different bond parameters.*/
+    const vector<BondParameters> & GetParameters() const { return parameters; }
+    /**Returns the index of some parameters in a table without repetitions, adding them if needed.
+    The tables are short (a few bond types), so they are searched linearly.
+    @param table the table.
+    @param Params the parameters.
+    @returns the index in the table.*/
+    static DWORD InternParameters(vector<BondParameters> &table, const BondParameters &Params);
+
+private:
+    /**Bond added by the IDs of its atoms, waiting for Build.*/
+    typedef struct {
+        id_t id1;
+        id_t id2;
+        WORD params;
+    } CPendingBond;
+
+    vector<CPendingBond> pending;
+    /**Different parameters of the bonds.*/
+    vector<BondParameters> parameters;
+
+    /**The adjacency lists: start of the list of each atom plus the end, the indexes of
+    the neighbours and the index in parameters of each bond.*/
+    vector<DWORD> rowStart;
+    vector<DWORD> neighbours;
+    vector<WORD> neighbourParams;
+    DWORD nBonds;
+
+    /**IDs of the atoms of the store sorted, and their indexes in the store.*/
+    vector<id_t> sortedIDs;
+    vector<DWORD> sortedIndexes;
+    /**IDs of the atoms of the store, by index, to keep the bonds on a new Build.*/
+    vector<id_t> atomIDs;
+
+public:
+    /**Constructor.*/
+    CBondStore() : nBonds(0) {}
+};
+
+class CBondStoreCollector : public NC_BondAction
+/**Action to add the iterated bonds to a CBondStore.*/
+{
+    CBondStore &store;
+public:
+    /**Constructor.
+    @param aStore the store where the bonds are added.*/
+    CBondStoreCollector(CBondStore &aStore) : store(aStore) {}
+    ERR DoAction(const NC_Bond &Bond)
+    {
+        store.Add(Bond);
+        return NULL;
+    }
+};
+
+#endif /*__BOND_STORE__H__*/
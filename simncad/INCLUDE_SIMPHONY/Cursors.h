@@ -0,0 +1,236 @@
+#ifndef __CURSORS__H__
+#define __CURSORS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "BondStore.h"
+#include "BatchActions.h"
+using namespace std;
+
+/**Default number of blocks the producer of a cursor can fill ahead of the consumer.*/
+#define CURSOR_DEPTH 4
+
+class CCursorSource
+/**Object of nCad whose atoms and bonds are iterated by the producer of a cursor.*/
+{
+public:
+    /**Destructor.*/
+    virtual ~CCursorSource() {}
+    /**Iterates the atoms, as the ForEachAtom of the object.*/
+    virtual ERR ForEachAtom(NC_AtomAction &AtomAction) const = 0;
+    /**Iterates the bonds, as the ForEachBond of the object.*/
+    virtual ERR ForEachBond(NC_BondAction &BondAction) const = 0;
+};
+
+template <class T>
+class CCursorSourceOf : public CCursorSource
+/**Cursor source for a NC_Cell, NC_Component or NC_Wrapper.*/
+{
+    const T &source;
+public:
+    /**Constructor.
+    @param aSource the object, which must be kept while the cursor is open.*/
+    CCursorSourceOf(const T &aSource) : source(aSource) {}
+    ERR ForEachAtom(NC_AtomAction &AtomAction) const { return source.ForEachAtom(AtomAction); }
+    ERR ForEachBond(NC_BondAction &BondAction) const { return source.ForEachBond(BondAction); }
+};
+
+//==============================================================================
+class CCursorQueue
+/**Bounded queue of blocks between the producer thread of a cursor, which runs the push
+iteration of nCad, and the consumer that pulls the blocks one by one.
+
+The blocks are kept in depth + 1 slots reused in turn: the producer fills at most depth
+blocks ahead while the consumer reads the last one it took, so the memory does not depend
+on the number of atoms and the consumer works while nCad generates the next blocks.
+Two semaphores count the free and the filled slots.*/
+{
+public:
+    /**Destructor. The derived cursors must stop the producer in their own destructor,
+    since it uses their members.*/
+    virtual ~CCursorQueue();
+    /**Stops the producer, if any, and forgets the blocks.*/
+    void Close();
+
+protected:
+    /**Constructor.
+    @param aDepth number of blocks the producer can fill ahead, at least 1.*/
+    CCursorQueue(DWORD aDepth);
+
+    /**Returns the number of slots of blocks.*/
+    DWORD GetSlots() const { return depth + 1; }
+    /**Starts the producer thread.
+    @param aSource the source iterated by Produce, deleted by Close.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR Start(CCursorSource *aSource);
+    /**Iterates the source on the producer thread, filling the blocks.
+    @returns NULL in case of success or the error of the iteration.*/
+    virtual ERR Produce(const CCursorSource &Source) = 0;
+
+    /**Producer side: waits for a free slot.
+    @param slot the index of the slot to fill.
+    @returns FALSE if the cursor was closed.*/
+    BOOL AcquireSlot(DWORD &slot);
+    /**Producer side: passes the filled slot to the consumer.*/
+    void PublishSlot();
+    /**Consumer side: releases the slot taken before, if any, and waits for the next one.
+    @param slot the index of the slot to read.
+    @param err set at the end to NULL or the error of the iteration.
+    @returns FALSE at the end of the iteration.*/
+    BOOL TakeSlot(DWORD &slot, ERR &err);
+
+private:
+    DWORD depth;
+    HANDLE thread;
+    HANDLE freeSlots;
+    HANDLE filledSlots;
+    volatile LONG closed;
+    CCursorSource *pSource;
+    /**Next slot to fill and to read.*/
+    DWORD writeSlot;
+    DWORD readSlot;
+    /**The consumer holds the slot it read last.*/
+    BOOL holding;
+    /**The consumer reached the end.*/
+    BOOL finished;
+    /**Result of Produce.*/
+    ERR result;
+    /**The slots that mark the end of the iteration.*/
+    vector<BYTE> endSlots;
+
+    /**Thread entry point.*/
+    static DWORD WINAPI ProducerProc(LPVOID pParam);
+
+    // Not copyable, the handles are owned
+    CCursorQueue(const CCursorQueue &);
+    CCursorQueue & operator=(const CCursorQueue &);
+};
+
+//==============================================================================
+class CAtomCursor : public CCursorQueue, private NC_AtomAction
+/**Pull iteration of the atoms of a NC_Cell, NC_Component, NC_Wrapper or CAtomStore in
+blocks. The nCad objects are iterated by a producer thread, so only a few blocks are in
+memory at any time.
+
+    CAtomCursor Cursor;
+    RETURN_IF_ERR(Cursor.Open(*pWrapper));
+    for (RETURN_IF_ERR(Cursor.Next()); Cursor.GetAtoms().count; RETURN_IF_ERR(Cursor.Next()))
+        ...use Cursor.GetAtoms()...
+*/
+{
+public:
+    /**Constructor.
+    @param aBatchSize number of atoms of the blocks.
+    @param aDepth number of blocks the producer can fill ahead.*/
+    CAtomCursor(DWORD aBatchSize = BATCH_SIZE, DWORD aDepth = CURSOR_DEPTH);
+    /**Destructor.*/
+    ~CAtomCursor() { Close(); }
+
+    /**Starts the iteration of the atoms of a nCad object.
+    @param Source the NC_Cell, NC_Component or NC_Wrapper, kept while the cursor is open.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    template <class T>
+    ERR Open(const T &Source)
+    {
+        Close();
+        return Start(new CCursorSourceOf<T>(Source));
+    }
+    /**Starts the iteration of the atoms of a store, which are read in place.
+    @param store the atoms, kept while the cursor is open.
+    @returns NULL.*/
+    ERR Open(const CAtomStore &store);
+    /**Stops the iteration.*/
+    void Close();
+
+    /**Moves to the next block, waiting for it if needed.
+    @returns NULL in case of success or the error of the iteration.*/
+    ERR Next();
+    /**Returns the current block, valid until the next call to Next or Close. It is empty
+    before the first block and at the end.*/
+    const NC_AtomSpan & GetAtoms() const { return atoms; }
+
+protected:
+    ERR Produce(const CCursorSource &Source);
+
+private:
+    DWORD batchSize;
+    /**The blocks of the slots, the names of each block are its own.*/
+    vector<CAtomStore> blocks;
+    NC_AtomSpan atoms;
+    /**Slot filled by the producer, if filling.*/
+    DWORD producerSlot;
+    BOOL filling;
+    /**Store iterated in place, if any, and the next atom to read.*/
+    const CAtomStore *pStore;
+    DWORD position;
+
+    /**Producer side: adds an atom to the block being filled.*/
+    ERR DoAction(const NC_Atom &Atom);
+    /**Producer side: publishes the block being filled, if any.*/
+    void Flush();
+};
+
+class CBondCursor : public CCursorQueue, private NC_BondAction
+/**Pull iteration of the bonds of a NC_Cell, NC_Component or NC_Wrapper in blocks, as
+CAtomCursor.*/
+{
+public:
+    /**Constructor.
+    @param aBatchSize number of bonds of the blocks.
+    @param aDepth number of blocks the producer can fill ahead.*/
+    CBondCursor(DWORD aBatchSize = BATCH_SIZE, DWORD aDepth = CURSOR_DEPTH);
+    /**Destructor.*/
+    ~CBondCursor() { Close(); }
+
+    /**Starts the iteration of the bonds of a nCad object.
+    @param Source the NC_Cell, NC_Component or NC_Wrapper, kept while the cursor is open.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    template <class T>
+    ERR Open(const T &Source)
+    {
+        Close();
+        return Start(new CCursorSourceOf<T>(Source));
+    }
+    /**Stops the iteration.*/
+    void Close();
+
+    /**Moves to the next block, waiting for it if needed.
+    @returns NULL in case of success or the error of the iteration.*/
+    ERR Next();
+    /**Returns the current block, valid until the next call to Next or Close. It is empty
+    before the first block and at the end.*/
+    const NC_BondSpan & GetBonds() const { return bonds; }
+
+    /**Block of bonds of a slot.*/
+    typedef struct {
+        vector<id_t> ids1;
+        vector<id_t> ids2;
+        vector<WORD> params;
+        /**Different parameters of the bonds of the block.*/
+        vector<BondParameters> parameters;
+    } CBondBlock;
+
+protected:
+    ERR Produce(const CCursorSource &Source);
+
+private:
+    DWORD batchSize;
+    vector<CBondBlock> blocks;
+    NC_BondSpan bonds;
+    /**Slot filled by the producer, if filling.*/
+    DWORD producerSlot;
+    BOOL filling;
+    /**Block without bonds, before the first block and at the end.*/
+    CBondBlock emptyBlock;
+
+    /**Producer side: adds a bond to the block being filled.*/
+    ERR DoAction(const NC_Bond &Bond);
+    /**Producer side: publishes the block being filled, if any.*/
+    void Flush();
+    /**Points bonds to a block.*/
+    void SetBonds(const CBondBlock &Block);
+};
+
+#endif /*__CURSORS__H__*/
@@ -0,0 +1,175 @@
+#ifndef __HASH_MAP__H__
+#define __HASH_MAP__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "Platform.h"
+using namespace std;
+
+/**Hash of a 64-bit integer key (the finalizer of MurmurHash3), so the consecutive keys
+such as the AtomIDs spread over the slots.*/
+inline DWORD64 HashKey(DWORD64 key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+//==============================================================================
+template <class K, class T>
+class CHashMap
+/**Hash map with open addressing: the entries are kept in
+arrays of a power of two slots, at most half full, and a key goes to the first free slot
+from its hash on (linear probing). So a lookup hashes two integers and usually reads one
+or two adjacent slots, without allocations. The keys are hashed by the HashKey overload
+of their type. The removals shift back the following
+entries of the run instead of leaving deleted marks, so the lookups do not slow down.
+
+The slots can be iterated by index (GetCapacity, IsUsed, GetKey and GetValue), in no
+particular order. Adding or removing entries moves them between the slots.*/
+{
+public:
+    /**Constructor.*/
+    CHashMap() : size(0) {}
+
+    /**Returns the number of entries.*/
+    DWORD GetSize() const { return size; }
+    /**Removes all the entries.*/
+    void Clear()
+    {
+        keys.clear();
+        values.clear();
+        used.clear();
+        size = 0;
+    }
+    /**Reserves slots for a number of entries, so they are added without rehashing.*/
+    void Reserve(DWORD n)
+    {
+        DWORD capacity = 16;
+        while (capacity < 2 * n)
+            capacity *= 2;
+        if (capacity > keys.size())
+            Rehash(capacity);
+    }
+
+    /**Returns TRUE if the key is in the map.*/
+    BOOL Has(const K &key) const { return Find(key) != NULL; }
+    /**Returns the value of a key, or NULL if it is not in the map.*/
+    T * Find(const K &key)
+    {
+        DWORD slot;
+        return FindSlot(key, slot) ? &values[slot] : NULL;
+    }
+    const T * Find(const K &key) const
+    {
+        DWORD slot;
+        return FindSlot(key, slot) ? &values[slot] : NULL;
+    }
+
+    /**Adds an entry if the key is not in the map yet.
+    @returns FALSE if the key was in the map, whose value is kept.*/
+    BOOL Insert(const K &key, const T &value)
+    {
+        if (2 * (size + 1) > keys.size())
+            Rehash(keys.empty() ? 16 : 2 * keys.size());
+        DWORD slot;
+        if (FindSlot(key, slot))
+            return FALSE;
+        keys[slot] = key;
+        values[slot] = value;
+        used[slot] = TRUE;
+        size++;
+        return TRUE;
+    }
+    /**Adds an entry or replaces the value of the key.*/
+    void Set(const K &key, const T &value)
+    {
+        T *pValue = Find(key);
+        if (pValue)
+            *pValue = value;
+        else
+            Insert(key, value);
+    }
+    /**Removes an entry.
+    @returns FALSE if the key was not in the map.*/
+    BOOL Remove(const K &key)
+    {
+        DWORD slot;
+        if (!FindSlot(key, slot))
+            return FALSE;
+        // The entries after it in the run move back if their home slot allows it
+        DWORD mask = keys.size() - 1;
+        DWORD next = (slot + 1) & mask;
+        while (used[next])
+        {
+            DWORD home = (DWORD)HashKey(keys[next]) & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask))
+            {
+                keys[slot] = keys[next];
+                values[slot] = values[next];
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        used[slot] = FALSE;
+        values[slot] = T();
+        size--;
+        return TRUE;
+    }
+
+    /**Returns the number of slots.*/
+    DWORD GetCapacity() const { return keys.size(); }
+    /**Returns TRUE if the slot has an entry.*/
+    BOOL IsUsed(DWORD slot) const { return used[slot]; }
+    /**Returns the key of a used slot.*/
+    const K & GetKey(DWORD slot) const { return keys[slot]; }
+    /**Returns the value of a used slot.*/
+    T & GetValue(DWORD slot) { return values[slot]; }
+    const T & GetValue(DWORD slot) const { return values[slot]; }
+
+private:
+    vector<K> keys;
+    vector<T> values;
+    vector<BYTE> used;
+    DWORD size;
+
+    /**Finds the slot of a key, or the free slot where it would go.
+    @returns TRUE if the key is in the map.*/
+    BOOL FindSlot(const K &key, DWORD &slot) const
+    {
+        if (keys.empty())
+            return FALSE;
+        DWORD mask = keys.size() - 1;
+        for (slot = (DWORD)HashKey(key) & mask; used[slot]; slot = (slot + 1) & mask)
+            if (keys[slot] == key)
+                return TRUE;
+        return FALSE;
+    }
+    /**Moves the entries to a number of slots.*/
+    void Rehash(DWORD capacity)
+    {
+        vector<K> oldKeys(capacity);
+        vector<T> oldValues(capacity);
+        vector<BYTE> oldUsed(capacity, FALSE);
+        keys.swap(oldKeys);
+        values.swap(oldValues);
+        used.swap(oldUsed);
+        DWORD mask = capacity - 1;
+        for (DWORD i = 0; i < oldKeys.size(); i++)
+            if (oldUsed[i])
+            {
+                DWORD slot = (DWORD)HashKey(oldKeys[i]) & mask;
+                while (used[slot])
+                    slot = (slot + 1) & mask;
+                keys[slot] = oldKeys[i];
+                values[slot] = oldValues[i];
+                used[slot] = TRUE;
+            }
+    }
+};
+
+#endif /*__HASH_MAP__H__*/
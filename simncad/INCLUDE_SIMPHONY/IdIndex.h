@@ -0,0 +1,52 @@
+#ifndef __ID_INDEX__H__
+#define __ID_INDEX__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include "WRAPPER/NC_Wrapper.h"
+#include "HashMap.h"
+#include "Uuid.h"
+using namespace std;
+
+class CIdIndex
+/**Bidirectional index between the internal ids of nCad (the AtomIDs) and the binary
+Simphony UUIDs, as two CHashMap, so both directions are found in O(1). Each id has one
+UUID and each UUID one id: setting a pair removes the previous pairs of both.*/
+{
+public:
+    /**Returns the number of pairs.*/
+    DWORD GetSize() const { return uuids.GetSize(); }
+    /**Removes all the pairs.*/
+    void Clear();
+    /**Reserves memory for a number of pairs.*/
+    void Reserve(DWORD n);
+
+    /**Sets the UUID of an id.
+    @param id the internal id.
+    @param Uuid the Simphony UUID.*/
+    void Set(id_t id, const CUuid &Uuid);
+    /**Sets the UUID of an id, given as 16 bytes in the order of uuid.UUID.bytes.*/
+    void Set(id_t id, const BYTE *uuid) { Set(id, UuidFromBytes(uuid)); }
+    /**Removes the pair of an id.
+    @returns FALSE if the id was not in the index.*/
+    BOOL RemoveID(id_t id);
+    /**Removes the pair of a UUID.
+    @returns FALSE if the UUID was not in the index.*/
+    BOOL RemoveUuid(const CUuid &Uuid);
+
+    /**Returns the UUID of an id, or NULL if it is not in the index.*/
+    const CUuid * FindUuid(id_t id) const { return uuids.Find(id); }
+    /**Returns the id of a UUID, or NULL if it is not in the index.*/
+    const id_t * FindID(const CUuid &Uuid) const { return ids.Find(Uuid); }
+    /**Returns the id of a UUID given as 16 bytes, or NULL if it is not in the index.*/
+    const id_t * FindID(const BYTE *uuid) const { return FindID(UuidFromBytes(uuid)); }
+    /**Writes the 16 bytes of the UUID of an id.
+    @returns FALSE if the id is not in the index.*/
+    BOOL GetUuidBytes(id_t id, BYTE *uuid) const;
+
+private:
+    CHashMap<id_t, CUuid> uuids;
+    CUuidMap<id_t> ids;
+};
+
+#endif /*__ID_INDEX__H__*/
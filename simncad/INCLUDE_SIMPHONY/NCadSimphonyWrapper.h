@@ -10,6 +10,11 @@
 #include "WRAPPER/NC_Wrapper.h"
 #include "VisualizerSimphony.h"
 #include "Factory_Shape.h"
+#include "BondStore.h"
+#include "Cursors.h"
+#include "SpatialOrder.h"
+#include "AssemblyArrays.h"
+#include "AssemblyBonds.h"
 using namespace std;
 
 /**The Simphony ID's type (currently string representation of the UUIDs.*/
@@ -471,6 +476,20 @@ public:
     
     /**Process all the components of the current assembly.*/
     void ProcessAll();
+    /**Creates the bonds of the specified cell between all the atoms of the cell closer than
+    the given distance, using a linked-cell neighbour search. Only the atoms inside the cell
+    are bonded, not the periodic images of the atoms in the neighbour cells (the cell shift
+    of CellBondID is not set), and the atoms of the same position are not bonded.
+    @param name the name of the cell.
+    @param distance maximal length of the bonds.
+    @param workers number of worker threads, 0 means one per processor.*/
+    void AutobondCell(string &name, double distance, DWORD workers);
+    /**Creates the bonds of the processed assembly between all the atoms closer than the given
+    distance, using a linked-cell neighbour search instead of the modeBondMaxLen iteration.
+    The atoms already bonded, e.g. by the bonds of their cell, are not bonded again.
+    @param distance maximal length of the bonds.
+    @param workers number of worker threads, 0 means one per processor.*/
+    void AutobondAssembly(double distance, DWORD workers);
     /**Clear all the components of the current assembly.*/
     void ClearComponents();
     /**Clear all the cells of the current assembly.*/
@@ -482,6 +501,37 @@ public:
     /**Obtains the assembly bonds from nCad and fills the given particle container with them.
     @param res the particle container to enter the bonds.*/
     void GetAssemblyBonds(CNCadParticleContainer * res);
+    /**Copies the atoms of the processed assembly from nCad to an atom store.
+    @param store the store where the atoms are appended.*/
+    void GetAssemblyAtomStore(CAtomStore &store);
+    /**Starts a pull iteration of the atoms of the processed assembly, read from nCad in
+    blocks on another thread while they are consumed.
+    @param cursor the cursor.*/
+    void OpenAssemblyAtomCursor(CAtomCursor &cursor);
+    /**Starts a pull iteration of the bonds of the processed assembly.
+    @param cursor the cursor.*/
+    void OpenAssemblyBondCursor(CBondCursor &cursor);
+    /**Writes the atoms of the processed assembly to a file of XYZ format, as
+    NC_Wrapper::ExportToXYZ, in the order of a space filling curve.
+    @param fileName the name of the file.
+    @param order the order of the atoms.
+    @param workers number of worker threads to sort the atoms, 0 means one per processor.*/
+    void ExportAssemblyToXYZ(const string &fileName, SpatialOrderType order, DWORD workers);
+    /**Copies the atoms and bonds of the processed assembly to flat arrays, to be read
+    from Python as NumPy arrays.
+    @param arrays the arrays, whose previous content is removed.
+    @param order the order of the atoms.
+    @param workers number of worker threads to sort the atoms, 0 means one per processor.*/
+    void GetAssemblyArrays(CAssemblyArrays &arrays, SpatialOrderType order, DWORD workers);
+    /**Makes the name based UUIDs of atoms of the processed assembly, as MakeAtomUuids. It does
+    not throw, so it can be called from Python without the GIL.
+    @param Namespace the 16 bytes UUID of the namespace.
+    @param n number of atoms.
+    @param ids the AtomIDs.
+    @param uuids the 16 bytes of the UUID of each atom.
+    @param workers number of worker threads, 0 means one per processor.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR MakeAssemblyUuids(const BYTE *Namespace, DWORD n, const id_t *ids, BYTE *uuids, DWORD workers);
     /**Method that prepare things for the assembly processing.*/
     void BeginAssembly();
     /**Method that finish assembly processing.*/
@@ -493,6 +543,13 @@ public:
     /**Special method to take a bond and insert a copy in the correspondent component after processing the assembly.
     @param pBond the bond to process.*/
     void ProcessAssemblyBond(CNCadBond * pBond, ID_TYPE Simphony_ID);
+    /**Adds the bonds of the assembly, with their atoms already resolved, to the container
+    of the assembly and processes them as ProcessAssemblyBond, instead of GetAssemblyBonds.
+    @param pAssembly the container of the assembly.
+    @param bonds the bonds, as read by CAssemblyBondArrays::Load.
+    @param bondUuids the 16 bytes Simphony UUID of each bond.*/
+    void ProcessAssemblyBonds(CNCadParticleContainer * pAssembly, const CAssemblyBondArrays &bonds,
+        const BYTE *bondUuids);
     /**Retrieves info of a particle of the assembly.
     @param id the internal id of the particle.
     @returns a CParticleInfo with the attributes of the particle.*/
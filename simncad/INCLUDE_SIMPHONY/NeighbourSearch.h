@@ -0,0 +1,79 @@
+#ifndef __NEIGHBOUR_SEARCH__H__
+#define __NEIGHBOUR_SEARCH__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+using namespace std;
+
+/**Pair of atoms closer than the cutoff.*/
+typedef struct {
+    /**Index of the first atom.*/
+    DWORD atom1;
+    /**Index of the second atom.*/
+    DWORD atom2;
+    /**Distance between the atoms.*/
+    double distance;
+} CNeighbourPair;
+
+class CNeighbourSearch
+/**Linked-cell search of all the atom pairs closer than a cutoff.
+
+The atoms are binned in a grid of bins not smaller than the cutoff, so each atom
+is only compared with the atoms of the 27 bins around it and the search is linear
+in the number of atoms. The atoms are split in ranges searched at the same time in a
+CTaskPool; every pair is reported once, from its first atom, and the result
+does not depend on the number of workers.*/
+{
+public:
+    /**Constructor.*/
+    CNeighbourSearch();
+
+    /**Prepares the search among a set of atoms.
+    @param xyz Cartesian coordinates of the atoms.
+    @param aCutoff maximal distance between the atoms of a pair.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR Init(const vector<Vector3D> &xyz, double aCutoff);
+
+    /**Finds all the pairs.
+    @param workers number of worker threads, 0 means one per processor.
+    @param pairs vector where the pairs are appended, sorted by first atom and second atom.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR FindPairs(DWORD workers, vector<CNeighbourPair> &pairs) const;
+
+    /**Finds the pairs whose first atom is in [first, last).
+    @param first index of the first atom to search.
+    @param last index of the atom after the last one.
+    @param pairs vector where the pairs are appended.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR FindPairs(DWORD first, DWORD last, vector<CNeighbourPair> &pairs) const;
+
+    /**Returns the number of atoms of the search.*/
+    DWORD GetNAtoms() const { return nAtoms; }
+
+private:
+    /**Maximal distance between the atoms of a pair.*/
+    double cutoff;
+    /**Number of atoms.*/
+    DWORD nAtoms;
+    /**Indexes of the atoms, sorted by bin.*/
+    vector<DWORD> binAtoms;
+    /**Index in binAtoms of the first atom of each bin, plus the end.*/
+    vector<DWORD> binStart;
+    /**Cartesian coordinates of the atoms.*/
+    vector<Vector3D> atomXYZ;
+    /**Lower corner of the grid.*/
+    Vector3D gridMin;
+    /**Edge of the bins.*/
+    double binSize;
+    /**Number of bins along x, y and z.*/
+    long dims[3];
+
+    /**Bins the atoms.*/
+    ERR BuildGrid();
+    /**Returns the index along each axis of the bin of a point.*/
+    void GetBinIndexes(const Vector3D &xyz, long index[3]) const;
+};
+
+#endif /*__NEIGHBOUR_SEARCH__H__*/
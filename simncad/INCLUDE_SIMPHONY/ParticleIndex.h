@@ -0,0 +1,146 @@
+#ifndef __PARTICLE_INDEX__H__
+#define __PARTICLE_INDEX__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include "NCadSimphonyWrapper.h"
+#include "Uuid.h"
+#include "IdIndex.h"
+#include "Symbols.h"
+using namespace std;
+
+class CParticleIndex
+/**Index of the particles and bonds of a CNCadParticleContainer by binary UUID.
+
+The container keys them by the UUID hex strings in trees, so each lookup from Python
+allocated the string of uid.hex and made log n string compares. The index keeps them in
+CUuidMap hash maps, looked up with the 16 bytes of uid.bytes, and the internal ids of the
+particles in a CIdIndex, instead of the linear search of GetParticleID. The changes of the
+container must go through the index to keep it up to date, or be followed by Invalidate (as
+the atoms that run adds to the components), which makes the next call index it again.
+
+The particles can also be added, updated, read and removed in bulk from arrays. These
+methods do not call Python and return the errors instead of throwing them, so they may be
+called without the GIL, though not concurrently with other calls for the same container.*/
+{
+public:
+    /**Constructor.
+    @param aContainer the container, which must be kept while the index is used.*/
+    CParticleIndex(CNCadParticleContainer &aContainer) : container(aContainer) { Rebuild(); }
+
+    /**Indexes again all the particles and bonds of the container.*/
+    void Rebuild();
+    /**Marks the index to be rebuilt by the next call, after the container was changed
+    without it.*/
+    void Invalidate() { stale = TRUE; }
+
+    /**Returns TRUE if the particle of the given 16 bytes UUID is in the container.*/
+    BOOL HasParticle(const BYTE *uuid) const { RebuildIfStale(); return particles.Has(UuidFromBytes(uuid)); }
+    /**Returns TRUE if the bond of the given 16 bytes UUID is in the container.*/
+    BOOL HasBond(const BYTE *uuid) const { RebuildIfStale(); return bonds.Has(UuidFromBytes(uuid)); }
+    /**Returns the particle of the given 16 bytes UUID, or NULL if it is not in the container.*/
+    CNCadParticle * GetParticle(const BYTE *uuid) const;
+    /**Returns the bond of the given 16 bytes UUID, or NULL if it is not in the container.*/
+    CNCadBond * GetBond(const BYTE *uuid) const;
+
+    /**Adds a particle to the container, as CNCadParticleContainer::AddParticle.
+    @param partInfo the particle, whose id is a UUID hex string.*/
+    void AddParticle(CParticleInfo &partInfo);
+    /**Adds a bond to the container, as CNCadParticleContainer::AddBond.
+    @param bondInfo the bond, whose id is a UUID hex string.*/
+    void AddBond(CBondInfo &bondInfo);
+    /**Updates a particle of the container, as CNCadParticleContainer::UpdateParticle.*/
+    void UpdateParticle(CParticleInfo &partInfo);
+    /**Updates a bond of the container, as CNCadParticleContainer::UpdateBond.*/
+    void UpdateBond(CBondInfo &bondInfo);
+    /**Removes the particle of the given 16 bytes UUID from the container.*/
+    void RemoveParticle(const BYTE *uuid);
+    /**Removes the bond of the given 16 bytes UUID from the container.*/
+    void RemoveBond(const BYTE *uuid);
+
+    /**Adds particles to the container, as AddParticle, with an occupancy of 1. All the
+    particles are checked before adding any, so on a duplicated UUID or a wrong code nothing
+    is added, while an error of the container stops the adding at that particle.
+    @param n number of particles.
+    @param uuids the 16 bytes UUID of each particle.
+    @param xyz the x, y and z coordinates of each particle.
+    @param species index in speciesNames of the chemical specie of each particle.
+    @param labels index in labelNames of the label of each particle.
+    @param speciesNames, labelNames the names of the codes.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR AddParticles(DWORD n, const BYTE *uuids, const double *xyz, const int *species, const int *labels,
+        const vector<string> &speciesNames, const vector<string> &labelNames);
+    /**Updates particles of the container, as UpdateParticle, from the same arrays as
+    AddParticles. Nothing is updated if a particle is not in the container.*/
+    ERR UpdateParticles(DWORD n, const BYTE *uuids, const double *xyz, const int *species, const int *labels,
+        const vector<string> &speciesNames, const vector<string> &labelNames);
+    /**Reads particles of the container to arrays, from the atoms of the nCad component or
+    cell, found by the internal ids of the index, without allocating a CParticleInfo each.
+    @param n number of particles.
+    @param uuids the 16 bytes UUID of each particle.
+    @param xyz array where the x, y and z coordinates of each particle are stored.
+    @param species array where the index in speciesNames of each chemical specie is stored.
+    @param labels array where the index in labelNames of each label is stored.
+    @param occupancies array where the occupancy of each particle is stored.
+    @param speciesNames, labelNames dictionaries where the names are added.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR GetParticles(DWORD n, const BYTE *uuids, double *xyz, int *species, int *labels, double *occupancies,
+        CSymbolTable &speciesNames, CSymbolTable &labelNames);
+    /**Removes particles from the container. Nothing is removed if a particle is not in the
+    container or is repeated, while an error of the container stops the removal at that particle.
+    @param n number of particles.
+    @param uuids the 16 bytes UUID of each particle.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    ERR RemoveParticles(DWORD n, const BYTE *uuids);
+
+    /**Writes the 16 bytes of the UUID of the particle of an internal id.
+    @returns FALSE if there is no particle with the id.*/
+    BOOL GetParticleUuid(id_t id, BYTE *uuid) const { RebuildIfStale(); return ids.GetUuidBytes(id, uuid); }
+
+    /**Returns the particles by UUID.*/
+    const CUuidMap<CNCadParticle *> & GetParticles() const { RebuildIfStale(); return particles; }
+    /**Returns the bonds by UUID.*/
+    const CUuidMap<CNCadBond *> & GetBonds() const { RebuildIfStale(); return bonds; }
+    /**Returns the index between the internal ids and the UUIDs of the particles.*/
+    const CIdIndex & GetParticleIDs() const { RebuildIfStale(); return ids; }
+
+private:
+    CNCadParticleContainer &container;
+    CUuidMap<CNCadParticle *> particles;
+    CUuidMap<CNCadBond *> bonds;
+    CIdIndex ids;
+    /**The container was changed without the index, which must be rebuilt.*/
+    BOOL stale;
+    /**Message of the last error of the bulk methods.*/
+    string error;
+
+    /**Rebuilds the index if it is stale (the lookups rebuild it when needed).*/
+    void RebuildIfStale() const;
+    /**Indexes a particle.*/
+    void SetParticle(const CUuid &Uuid, CNCadParticle *pParticle);
+    /**Adds a particle of a known UUID.*/
+    void AddParticle(const CUuid &Uuid, CParticleInfo &partInfo);
+    /**Updates a particle of a known UUID.*/
+    void UpdateParticle(const CUuid &Uuid, CParticleInfo &partInfo);
+    /**Returns the atom of nCad of a particle, or NULL if the container has no nCad object.*/
+    const NC_Atom * GetAtom(const CNCadParticle &Particle) const;
+    /**Fills the information of the particle i of the arrays of AddParticles, reusing the
+    strings of partInfo.*/
+    static void GetParticleInfo(DWORD i, const CUuid &Uuid, const double *xyz, const int *species,
+        const int *labels, const vector<string> &speciesNames, const vector<string> &labelNames,
+        CParticleInfo &partInfo);
+    /**Checks the UUIDs and the codes of the arrays of AddParticles and UpdateParticles.
+    @param existing TRUE if the particles must be in the container, FALSE if they must not.*/
+    ERR CheckParticles(DWORD n, const BYTE *uuids, const int *species, const int *labels,
+        DWORD nSpecies, DWORD nLabels, BOOL existing);
+    /**Keeps the message of an error and returns it.*/
+    ERR SetError(const string &message);
+    /**Parses the UUID of an id of the container.*/
+    static CUuid ParseID(const ID_TYPE &id);
+
+    // Not copyable, it refers to the container
+    CParticleIndex(const CParticleIndex &);
+    CParticleIndex & operator=(const CParticleIndex &);
+};
+
+#endif /*__PARTICLE_INDEX__H__*/
@@ -0,0 +1,40 @@
+#ifndef __SHA1__H__
+#define __SHA1__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include "Platform.h"
+
+/**Number of bytes of a SHA-1 digest.*/
+#define SHA1_BYTES 20
+
+class CSha1
+/**SHA-1 message digest (FIPS 180-4), as hashlib.sha1, used for the name based UUIDs.
+The message is given in any number of parts.*/
+{
+public:
+    /**Constructor.*/
+    CSha1() { Reset(); }
+
+    /**Starts a new message.*/
+    void Reset();
+    /**Adds bytes to the message.
+    @param data the bytes.
+    @param size number of bytes.*/
+    void Update(const BYTE *data, DWORD size);
+    /**Ends the message and returns its digest. Reset must be called before a new message.
+    @param digest the SHA1_BYTES of the digest.*/
+    void Final(BYTE *digest);
+
+private:
+    DWORD state[5];
+    /**Length of the message in bytes.*/
+    DWORD64 length;
+    /**Bytes of the message not processed yet, less than a block.*/
+    BYTE block[64];
+
+    /**Processes a block of 64 bytes.*/
+    void Transform(const BYTE *data);
+};
+
+#endif /*__SHA1__H__*/
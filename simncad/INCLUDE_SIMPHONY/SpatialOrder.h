@@ -0,0 +1,60 @@
+#ifndef __SPATIAL_ORDER__H__
+#define __SPATIAL_ORDER__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include "WRAPPER/NC_Wrapper.h"
+#include "AtomStore.h"
+#include "BondStore.h"
+using namespace std;
+
+/**Bits of each coordinate in the keys of the space filling curves.*/
+#define SPATIAL_KEY_BITS 21
+
+/**Order of the atoms on output.*/
+enum SpatialOrderType
+{
+    /**The order of nCad (component and AtomID).*/
+    spatialOrderNone,
+    /**Z order curve: the bits of the coordinates interleaved.*/
+    spatialOrderMorton,
+    /**Hilbert curve, which has no jumps between distant regions, so it keeps the
+    neighbours a little closer than the Morton order.*/
+    spatialOrderHilbert
+};
+
+/**Computes the key of each point on a space filling curve over the bounding box of the
+points. The coordinates are quantized to SPATIAL_KEY_BITS bits with the same step along
+the three axes, so the cells of the curve are cubes.
+@param Points the points.
+@param type the curve, spatialOrderNone gives the index of each point.
+@param keys vector where the keys are stored, resized as needed.
+@param workers number of worker threads, 0 means one per processor.*/
+void GetSpatialKeys(const CPointArray &Points, SpatialOrderType type, vector<DWORD64> &keys, DWORD workers = 0);
+
+/**Sorts keys by least significant digit radix sort, the digits of each pass counted and
+scattered in parallel over ranges of keys. The sort is stable.
+@param keys the keys.
+@param order vector where the indexes of the keys in ascending order are stored.
+@param workers number of worker threads, 0 means one per processor.*/
+void RadixSortKeys(const vector<DWORD64> &keys, vector<DWORD> &order, DWORD workers = 0);
+
+/**Computes the order of some points along a space filling curve.
+@param Points the points.
+@param type the curve.
+@param order vector where the index of the point to put at each position is stored.
+@param workers number of worker threads, 0 means one per processor.*/
+void GetSpatialOrder(const CPointArray &Points, SpatialOrderType type, vector<DWORD> &order, DWORD workers = 0);
+
+/**Sorts the atoms of a store along a space filling curve, so the atoms close in space are
+close in memory and on output. The bonds indexed over the atoms are remapped to the new
+indexes.
+@param atoms the atoms.
+@param bonds the bonds of the atoms, as built over the store, or an empty store.
+@param type the curve.
+@param workers number of worker threads, 0 means one per processor.
+@returns NULL in case of success or pointer to the error string in case of failure.*/
+ERR SortSpatially(CAtomStore &atoms, CBondStore &bonds, SpatialOrderType type, DWORD workers = 0);
+
+#endif /*__SPATIAL_ORDER__H__*/
@@ -0,0 +1,67 @@
+#ifndef __SYMBOLS__H__
+#define __SYMBOLS__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include <map>
+#include <string>
+#include "Platform.h"
+using namespace std;
+
+/**Chemical elements by atomic number, elementNone for the species that are not elements.*/
+enum ElementNumber
+{
+    elementNone, elementH, elementHe, elementLi, elementBe, elementB, elementC, elementN,
+    elementO, elementF, elementNe, elementNa, elementMg, elementAl, elementSi, elementP,
+    elementS, elementCl, elementAr, elementK, elementCa, elementSc, elementTi, elementV,
+    elementCr, elementMn, elementFe, elementCo, elementNi, elementCu, elementZn, elementGa,
+    elementGe, elementAs, elementSe, elementBr, elementKr, elementRb, elementSr, elementY,
+    elementZr, elementNb, elementMo, elementTc, elementRu, elementRh, elementPd, elementAg,
+    elementCd, elementIn, elementSn, elementSb, elementTe, elementI, elementXe, elementCs,
+    elementBa, elementLa, elementCe, elementPr, elementNd, elementPm, elementSm, elementEu,
+    elementGd, elementTb, elementDy, elementHo, elementEr, elementTm, elementYb, elementLu,
+    elementHf, elementTa, elementW, elementRe, elementOs, elementIr, elementPt, elementAu,
+    elementHg, elementTl, elementPb, elementBi, elementPo, elementAt, elementRn, elementFr,
+    elementRa, elementAc, elementTh, elementPa, elementU, elementNp, elementPu, elementAm,
+    elementCm, elementBk, elementCf, elementEs, elementFm, elementMd, elementNo, elementLr,
+    elementRf, elementDb, elementSg, elementBh, elementHs, elementMt, elementDs, elementRg,
+    elementCn, elementNh, elementFl, elementMc, elementLv, elementTs, elementOg,
+    elementMAX
+};
+
+/**Returns the element of a chemical species, ignoring the case of the symbol and an ionic
+charge after it (e.g. "si", "Si4+" and "O2-" are silicon and oxygen).
+@param species the species.
+@returns the element, or elementNone if the species is not an element symbol.*/
+ElementNumber GetElementNumber(const string &species);
+
+/**Returns the symbol of an element ("" for elementNone).*/
+const string & GetElementSymbol(ElementNumber element);
+
+/**Index returned by CSymbolTable::Find for the names not in the table.*/
+#define SYMBOL_NONE ((DWORD)-1)
+
+class CSymbolTable
+/**Dictionary of names (e.g. the atom labels of a unit cell) giving each one a small index,
+so the atoms keep and compare an integer instead of a string. The names are case
+sensitive and keep the index of their first insertion.*/
+{
+public:
+    /**Returns the index of a name, adding it if needed.*/
+    DWORD Intern(const string &name);
+    /**Returns the index of a name, or SYMBOL_NONE if it is not in the table.*/
+    DWORD Find(const string &name) const;
+    /**Returns the name of an index.*/
+    const string & GetName(DWORD index) const { return names[index]; }
+    /**Returns the number of names.*/
+    DWORD GetSize() const { return names.size(); }
+    /**Removes all the names.*/
+    void Clear();
+
+private:
+    vector<string> names;
+    map<string, DWORD> indexes;
+};
+
+#endif /*__SYMBOLS__H__*/
@@ -0,0 +1,94 @@
+#ifndef __TASK_POOL__H__
+#define __TASK_POOL__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include <deque>
+#include <string>
+#include "Platform.h"
+using namespace std;
+
+class CTask
+/**Base class for the units of work executed by the CTaskPool.*/
+{
+public:
+    /**Destructor.*/
+    virtual ~CTask() {}
+    /**The work to perform. It is called exactly once, from any of the workers.
+    @returns NULL in case of success or pointer to the error string in case of failure.*/
+    virtual ERR Run() = 0;
+    /**Estimated cost of the task, only used to order the initial distribution
+    of the tasks among the workers (any positive scale is valid).
+    @returns the estimated cost.*/
+    virtual double GetCost() const { return 1.0; }
+};
+
+class CTaskPool
+/**Fork-join pool of worker threads with work stealing.
+
+Tasks are dealt to per-worker queues in decreasing cost order. Each worker
+takes the most expensive task of its own queue and, once it is empty, steals
+the cheapest remaining task of another worker. This way a single huge task
+does not keep a queue of small tasks waiting behind it.
+
+The pool does not impose any ordering on the tasks execution, but the error
+reported by Run is always the one of the first failed task in the given order,
+so the result does not depend on the scheduling.*/
+{
+public:
+    /**Constructor.
+    @param aWorkers number of workers, 0 means one worker per processor.*/
+    CTaskPool(DWORD aWorkers = 0);
+    /**Destructor.*/
+    ~CTaskPool();
+
+    /**Returns the number of processors of the machine.
+    @returns number of processors (at least 1).*/
+    static DWORD GetDefaultWorkers();
+    /**Returns the number of workers of the pool.
+    @returns number of workers.*/
+    DWORD GetWorkers() const { return workers; }
+
+    /**Runs all the tasks and waits until they are finished. The calling thread
+    is used as one of the workers. The tasks are not deleted.
+    @param tasks the tasks to run.
+    @returns NULL in case of success or the error of the first failed task.*/
+    ERR Run(const vector<CTask*> &tasks);
+
+private:
+    /**Queue of task indexes owned by a single worker.*/
+    struct CWorkerQueue
+    {
+        CRITICAL_SECTION lock;
+        deque<DWORD> tasks;
+    };
+    /**Parameters passed to each worker thread.*/
+    struct CWorkerParam
+    {
+        CTaskPool *pPool;
+        DWORD worker;
+    };
+
+    /**Number of workers.*/
+    DWORD workers;
+    /**Tasks of the current Run call.*/
+    const vector<CTask*> *pTasks;
+    /**Result of each task of the current Run call.*/
+    vector<ERR> results;
+    /**Storage for the messages of the exceptions thrown by the tasks.*/
+    vector<string> messages;
+    /**Queues of the workers of the current Run call.*/
+    vector<CWorkerQueue*> queues;
+
+    /**Takes the next task of the worker's own queue.*/
+    BOOL PopOwn(DWORD worker, DWORD &task);
+    /**Takes a task from the queue of another worker.*/
+    BOOL Steal(DWORD worker, DWORD &task);
+    /**Executes tasks until there is nothing left to run or steal.*/
+    void WorkerLoop(DWORD worker);
+    /**Thread entry point.*/
+    static DWORD WINAPI WorkerProc(LPVOID pParam);
+};
+
+#endif /*__TASK_POOL__H__*/
@@ -0,0 +1,64 @@
+#ifndef __UUID__H__
+#define __UUID__H__
+
+/**@pkg _SIMPHONY_ADAPTER*/
+
+#include <vector>
+#include <string>
+#include "Platform.h"
+#include "HashMap.h"
+using namespace std;
+
+/**Number of bytes of a UUID.*/
+#define UUID_BYTES 16
+/**Number of hexadecimal digits of a UUID without hyphens.*/
+#define UUID_HEX_DIGITS 32
+
+/**128-bit UUID in binary form, the first 8 bytes (big endian, as uuid.UUID.bytes) in high.*/
+typedef struct CUuid {
+    DWORD64 high;
+    DWORD64 low;
+} CUuid;
+
+inline BOOL operator==(const CUuid &a, const CUuid &b) { return a.high == b.high && a.low == b.low; }
+inline BOOL operator!=(const CUuid &a, const CUuid &b) { return !(a == b); }
+inline BOOL operator<(const CUuid &a, const CUuid &b)
+{
+    return a.high < b.high || (a.high == b.high && a.low < b.low);
+}
+
+/**Returns the UUID of 16 bytes in the order of uuid.UUID.bytes.*/
+CUuid UuidFromBytes(const BYTE *bytes);
+/**Writes the 16 bytes of a UUID in the order of uuid.UUID.bytes.*/
+void UuidToBytes(const CUuid &Uuid, BYTE *bytes);
+/**Parses a UUID written with 32 hexadecimal digits, as uuid.UUID.hex, or with hyphens.
+@param hex the digits.
+@param Uuid the parsed UUID.
+@returns FALSE if it is not a UUID.*/
+BOOL UuidFromHex(const string &hex, CUuid &Uuid);
+/**Returns the 32 lowercase hexadecimal digits of a UUID, as uuid.UUID.hex.*/
+string UuidToHex(const CUuid &Uuid);
+/**Writes the 32 lowercase hexadecimal digits of a UUID to a string, reusing its memory.*/
+void UuidToHex(const CUuid &Uuid, string &hex);
+/**Returns the name based UUID (version 5, SHA-1) of a name in a namespace, as uuid.uuid5.
+The same name in the same namespace always gives the same UUID.
+@param Namespace the UUID of the namespace.
+@param name the bytes of the name.
+@param size number of bytes of the name.*/
+CUuid UuidFromName(const CUuid &Namespace, const BYTE *name, DWORD size);
+
+/**Hash of a UUID, as used by CHashMap. Random UUIDs are already uniform, but the time based
+and name based ones have fixed bits, so the two halves are mixed.*/
+inline DWORD64 HashKey(const CUuid &Uuid)
+{
+    return HashKey(Uuid.high ^ (Uuid.low * 0x9E3779B97F4A7C15ULL));
+}
+
+//==============================================================================
+template <class T>
+class CUuidMap : public CHashMap<CUuid, T>
+/**Hash map from binary UUIDs to values.*/
+{
+};
+
+#endif /*__UUID__H__*/
@@ -85,9 +85,10 @@ def read_cd(file_name):
         tmp = f.readline()
         items = tmp.split()
 
-        Label = items[0]
+        # Interned, so all the particles share the same strings
+        Label = intern(items[0])
         #print Label
-        Element = items[1]
+        Element = intern(items[1])
         #print Element
 
         x = float(items[2])
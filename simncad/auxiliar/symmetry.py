@@ -231,16 +231,40 @@ SymmmetryHM = [
 "Ia-3d"
 ]
 
-#counts from 1, returns -1 on error, case sensitive
+# Short names accepted besides the full symbols of SymmmetryHM
+SymmetryAliases = {"P2": 3, "P21": 4, "C2": 5, "Pm": 6, "Pc": 7, "Cm": 8,
+                   "Cc": 9, "P2/m": 10, "P21/m": 11, "C2/m": 12, "P2/c": 13,
+                   "P21/c": 14, "C2/c": 15}
+
+
+def _NormalizeHM(symHM):
+    """Removes the blanks and underscores of a Hermann-Mauguin symbol."""
+    return "".join(c for c in symHM if not c.isspace() and c != "_")
+
+
+def _BuildSymmetryNumbers():
+    numbers = dict(SymmetryAliases)
+    for index, name in enumerate(SymmmetryHM):
+        numbers[name] = index + 1
+        # The origin choice and the axes may be omitted
+        if ":" in name:
+            numbers.setdefault(name.split(":")[0], index + 1)
+    return numbers
+
+_SymmetryNumbers = _BuildSymmetryNumbers()
+
+
+#counts from 1, returns -1 on error, case sensitive, blanks are ignored
 def GetSymmetryNumberByHM(symHM):
-    try:
-        return 1 + SymmmetryHM.index(symHM)
-    except:
+    if not isinstance(symHM, basestring):
         return -1
+    return _SymmetryNumbers.get(_NormalizeHM(symHM), -1)
 
 #counts from 1, returns "" on error
 def GetSymmetryHMByNumber(sym_num):
     try:
+        if sym_num < 1:
+            return ""
         return SymmmetryHM[sym_num - 1]
     except:
         return ""
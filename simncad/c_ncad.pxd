@@ -1,5 +1,6 @@
 from libcpp.string cimport string
 from libcpp.map cimport map
+from libcpp.vector cimport vector
 from libcpp cimport bool 
 ctypedef string ID_TYPE
 
@@ -35,7 +36,9 @@ cdef extern from "NCadSimphonyWrapper.h":
         void TraceAll()
         void ShowComponent(string &name) except +get_error_cython
         void ShowCell(string &name) except +get_error_cython
-        void ProcessAll()
+        void ProcessAll() nogil except +get_error_cython
+        void AutobondCell(string &name, double distance, unsigned int workers) except +get_error_cython
+        void AutobondAssembly(double distance, unsigned int workers) except +get_error_cython
         # CNCadParticleContainer * GetAssembly();
         void GetAssemblyAtoms(CNCadParticleContainer * res) except +get_error_cython
         void GetAssemblyBonds(CNCadParticleContainer * res) except +get_error_cython
@@ -45,12 +48,114 @@ cdef extern from "NCadSimphonyWrapper.h":
         CBondInfo* GetAssemblyBondInfo(long long int id) except +get_error_cython
         void ProcessAssemblyParticle(CNCadParticle * pParticle, ID_TYPE Simphony_ID) except +get_error_cython 
         void ProcessAssemblyBond(CNCadBond * pBond, ID_TYPE Simphony_ID) except +get_error_cython
+        void ProcessAssemblyBonds(CNCadParticleContainer * pAssembly,
+                                  const CAssemblyBondArrays &bonds,
+                                  const unsigned char *bondUuids) except +get_error_cython
         void LoadSession(string session);
+        void OpenAssemblyAtomCursor(CAtomCursor &cursor) except +get_error_cython
+        void OpenAssemblyBondCursor(CBondCursor &cursor) except +get_error_cython
+        void ExportAssemblyToXYZ(const string &fileName, SpatialOrderType order,
+                                 DWORD workers) except +get_error_cython
+        const char * MakeAssemblyUuids(const unsigned char *namespace, DWORD n,
+                                       const unsigned long long *ids,
+                                       unsigned char *uuids, DWORD workers) nogil
+        void GetAssemblyArrays(CAssemblyArrays &arrays, SpatialOrderType order,
+                               DWORD workers) except +get_error_cython
 
 cdef extern from "NCadSimphonyWrapper.h":
     CNCadSimphony * pCNCadSimphony
 
 
+cdef extern from "Platform.h":
+    ctypedef unsigned long DWORD
+
+cdef extern from "AtomStore.h":
+    cdef cppclass CPointArray:
+        vector[double] x
+        vector[double] y
+        vector[double] z
+
+cdef extern from "SpatialOrder.h":
+    ctypedef enum SpatialOrderType:
+        spatialOrderNone
+        spatialOrderMorton
+        spatialOrderHilbert
+    void GetSpatialOrder(const CPointArray &Points, SpatialOrderType type,
+                         vector[DWORD] &order, DWORD workers)
+
+cdef extern from "AtomStore.h":
+    cdef cppclass CAtomStore:
+        unsigned int GetSize() const
+        const string & GetElement(unsigned int i) const
+        const string & GetLabel(unsigned int i) const
+
+cdef extern from "Symbols.h":
+    cdef cppclass CSymbolTable:
+        const string & GetName(DWORD index) const
+        DWORD GetSize() const
+
+cdef extern from "AssemblyArrays.h":
+    cdef cppclass CAssemblyArrays:
+        DWORD GetNAtoms() const
+        DWORD GetNBonds() const
+        const unsigned long long * GetIDs() const
+        const double * GetCoordinates() const
+        const unsigned short * GetSpecies() const
+        const DWORD * GetLabels() const
+        const double * GetOccupancies() const
+        const DWORD * GetComponents() const
+        const DWORD * GetBondAtoms() const
+        const CSymbolTable & GetSpeciesNames() const
+        const CSymbolTable & GetLabelNames() const
+        const CSymbolTable & GetComponentNames() const
+        void FindInBox(const double *lower, const double *upper,
+                       vector[DWORD] &indexes) const
+        void FindInRadius(const double *center, double radius,
+                          vector[DWORD] &indexes) const
+
+cdef extern from "AtomUuids.h":
+    const char * MakeBondUuids(const unsigned char *namespace, DWORD n,
+                               const unsigned char *uuids1,
+                               const unsigned char *uuids2,
+                               unsigned char *uuids, DWORD workers) nogil
+
+cdef extern from "AssemblyBonds.h":
+    cdef cppclass CAssemblyBondArrays:
+        DWORD GetSize() const
+        const unsigned long long * GetIDs1() const
+        const unsigned long long * GetIDs2() const
+        const unsigned char * GetUuids1() const
+        const unsigned char * GetUuids2() const
+
+cdef extern from "BatchActions.h":
+    ctypedef struct NC_AtomSpan:
+        const CAtomStore *pStore
+        unsigned int first
+        unsigned int count
+        const unsigned long long *ids
+        const double *x
+        const double *y
+        const double *z
+
+    ctypedef struct NC_BondSpan:
+        unsigned int count
+        const unsigned long long *ids1
+        const unsigned long long *ids2
+
+cdef extern from "Cursors.h":
+    cdef cppclass CAtomCursor:
+        CAtomCursor(unsigned int batch_size)
+        void Close()
+        const char * Next() nogil
+        NC_AtomSpan GetAtoms()
+
+    cdef cppclass CBondCursor:
+        CBondCursor(unsigned int batch_size)
+        void Close()
+        const char * Next() nogil
+        NC_BondSpan GetBonds()
+
+
 cdef extern from "NCadSimphonyWrapper.h":
     cdef cppclass CNCadParticleContainer:
         CNCadParticleContainer() except +
@@ -77,6 +182,66 @@ cdef extern from "NCadSimphonyWrapper.h":
         CNCadParticleContainer * GetCopy()
         void Update(CParticleContainerInfo &pc_info) except +get_error_cython
         
+cdef extern from "AsyncJob.h":
+    DWORD INFINITE
+    cdef cppclass CAsyncJob:
+        const char * Start()
+        bint IsDone()
+        bint Wait(DWORD milliseconds) nogil
+        const char * GetError()
+
+    cdef cppclass CAssemblyJob(CAsyncJob):
+        CAssemblyJob(CNCadSimphony &ncad, DWORD workers,
+                     double bond_max_length,
+                     CNCadParticleContainer *assembly)
+
+    cdef cppclass CAssemblyBondsJob(CAsyncJob):
+        CAssemblyBondsJob(const CIdIndex &atom_uuids,
+                          CAssemblyBondArrays &bonds, DWORD workers)
+
+cdef extern from "IdIndex.h":
+    cdef cppclass CIdIndex:
+        DWORD GetSize()
+        void Clear()
+        void Reserve(DWORD n)
+        void Set(unsigned long long id, const unsigned char *uuid)
+        bint RemoveID(unsigned long long id)
+        bint GetUuidBytes(unsigned long long id, unsigned char *uuid)
+        const unsigned long long * FindID(const unsigned char *uuid)
+
+cdef extern from "ParticleIndex.h":
+    cdef cppclass CParticleIndex:
+        CParticleIndex(CNCadParticleContainer &container) except +get_error_cython
+        void Rebuild() except +get_error_cython
+        void Invalidate()
+        bint HasParticle(const unsigned char *uuid)
+        bint HasBond(const unsigned char *uuid)
+        CNCadParticle * GetParticle(const unsigned char *uuid)
+        CNCadBond * GetBond(const unsigned char *uuid)
+        void AddParticle(CParticleInfo &partInfo) except +get_error_cython
+        void AddBond(CBondInfo &bondInfo) except +get_error_cython
+        void UpdateParticle(CParticleInfo &partInfo) except +get_error_cython
+        void UpdateBond(CBondInfo &bondInfo) except +get_error_cython
+        void RemoveParticle(const unsigned char *uuid) except +get_error_cython
+        void RemoveBond(const unsigned char *uuid) except +get_error_cython
+        bint GetParticleUuid(unsigned long long id, unsigned char *uuid)
+        const char * AddParticles(DWORD n, const unsigned char *uuids,
+                                  const double *xyz, const int *species,
+                                  const int *labels,
+                                  const vector[string] &speciesNames,
+                                  const vector[string] &labelNames) nogil
+        const char * UpdateParticles(DWORD n, const unsigned char *uuids,
+                                     const double *xyz, const int *species,
+                                     const int *labels,
+                                     const vector[string] &speciesNames,
+                                     const vector[string] &labelNames) nogil
+        const char * GetParticles(DWORD n, const unsigned char *uuids,
+                                  double *xyz, int *species, int *labels,
+                                  double *occupancies,
+                                  CSymbolTable &speciesNames,
+                                  CSymbolTable &labelNames) nogil
+        const char * RemoveParticles(DWORD n, const unsigned char *uuids) nogil
+
 cdef extern from "NCadSimphonyWrapper.h":
     cdef cppclass CNCadComponent(CNCadParticleContainer):
         CNCadComponent() except +
@@ -1,6 +1,8 @@
 from libcpp.string cimport string
 from libcpp.map cimport map
+from libcpp.vector cimport vector
 from cython.operator cimport dereference as deref, preincrement as inc
+from cpython.buffer cimport PyBUF_WRITABLE
 
 from simphony.core.data_container import DataContainer
 import simphony.cuds.particles as p
@@ -12,12 +14,68 @@ cimport c_ncad
 import random
 import copy
 import uuid
+import numpy
 from auxiliar.ncad_types import (
     SHAPE_TYPE,
     SYMMETRY_GROUP,
     AXIS_TYPE
 )
 
+# Number of particles read at once by iter_particles
+_PARTICLE_BATCH = 4096
+
+# Namespace of the uids of the assembly atoms of each session, which are
+# name based (version 5) so the same assembly always gets the same uids
+NCAD_NAMESPACE = uuid.uuid5(uuid.NAMESPACE_DNS, 'ncad.simphony-project.eu')
+
+# Orders of the atoms of the assembly on output
+_ATOM_ORDERS = {None: c_ncad.spatialOrderNone,
+                'morton': c_ncad.spatialOrderMorton,
+                'hilbert': c_ncad.spatialOrderHilbert}
+
+
+def _bond_uid_bytes(bytes namespace, bytes uuids1, bytes uuids2, workers):
+    """Returns the bytes of the name based uids of n bonds, made in C++ from
+    the 16 * n bytes of the uids of their atoms, in an n x 16 array of
+    uint8. The uid of a bond is uuid.uuid5(namespace, uid1.bytes +
+    uid2.bytes), with the lower uid of its atoms first."""
+    cdef c_ncad.DWORD n = len(uuids1) // 16
+    uids = numpy.empty((n, 16), numpy.uint8)
+    cdef unsigned char[:, ::1] c_uids = uids
+    cdef const unsigned char *c_namespace = namespace
+    cdef const unsigned char *c_uuids1 = uuids1
+    cdef const unsigned char *c_uuids2 = uuids2
+    cdef c_ncad.DWORD c_workers = workers
+    cdef const char *err = NULL
+    if n > 0:
+        with nogil:
+            err = c_ncad.MakeBondUuids(c_namespace, n, c_uuids1, c_uuids2,
+                                       &c_uids[0, 0], c_workers)
+    if err != NULL:
+        raise Exception(err)
+    return uids
+
+
+def uid_array(uids):
+    """Returns the bytes of some uids as an array for the bulk methods.
+
+    Parameters
+    ----------
+    uids : iterable of uuid.UUID or array_like of uint8
+        the uids, or an n x 16 array of their bytes, which is returned as is
+        if it is already a writable contiguous array of uint8.
+
+    Returns
+    -------
+    An n x 16 numpy.ndarray of uint8.
+
+    """
+    if not isinstance(uids, numpy.ndarray):
+        uids = numpy.array(bytearray(b''.join(uid.bytes for uid in uids)),
+                           numpy.uint8)
+    uids = numpy.require(uids, numpy.uint8, ['C', 'W']).reshape(-1, 16)
+    return uids
+
 
 cdef class _NCadParticles:
     """Particle Container wrapper class for nCad adapter.
@@ -28,11 +86,14 @@ cdef class _NCadParticles:
     ----------
     thisptr : CNCadParticleContainer pointer
         pointer to the C++ particle container
+    index : CParticleIndex pointer
+        index of the particles and bonds of the container by binary uid
     _data : DataContainer
         data attributes of the particle container
 
     """
     cdef c_ncad.CNCadParticleContainer *thisptr
+    cdef c_ncad.CParticleIndex *index
     cdef public object _data
 
     def __init__(self, *args):
@@ -59,9 +120,12 @@ cdef class _NCadParticles:
             self.thisptr = new c_ncad.CNCadCell()
         else:
             raise Exception("No type specified! ('component' or 'cell')")
+        self.index = new c_ncad.CParticleIndex(deref(self.thisptr))
 
     def __dealloc__(self):
         """Cython destructor."""
+        del self.index
+        self.index = NULL
         del self.thisptr
         self.thisptr = NULL
 
@@ -103,35 +167,55 @@ cdef class _NCadParticles:
         >>> uids = particles.add_particles(particle_list)
 
         """
-        res = []
-        for particle in iterable:
-            res.append(self._add_particle(particle))
-        return res
+        particles = list(iterable)
+        for particle in particles:
+            if particle.uid is None:
+                particle.uid = uuid.uuid4()
+        self._set_particles(particles, False)
+        return [particle.uid for particle in particles]
 
-    
-    def _add_particle(self, particle):
-        """Adds the particle to the container.
+    def add_particle_arrays(self, coordinates, species, species_names,
+                            labels=None, label_names=None, uids=None):
+        """Adds particles given as arrays, without Particle objects.
+
+        All the particles are checked before adding any of them, and they
+        are added to nCad without holding the GIL.
 
         Parameters
         ----------
-        particle : Particle
-            the new particle in the container.
+        coordinates : array_like
+            n x 3 coordinates of the particles.
+        species : array_like of int
+            index in species_names of the chemical specie of each particle.
+        species_names : list of str
+            names of the chemical species.
+        labels : array_like of int
+            index in label_names of the label of each particle, by default
+            the labels are the chemical species.
+        label_names : list of str
+            names of the labels.
+        uids : array_like of uint8
+            n x 16 bytes of the uids of the particles (see uid_array), by
+            default new random uids.
 
         Returns
         -------
-        Id of the added particle.
+        uids : numpy.ndarray of uint8
+            n x 16 bytes of the uids of the added particles.
 
         Raises
-        -------
-        Exception when the particle already exists in the container, or when
-        the particle can't be added due to internal errors.
+        ------
+        Exception :
+            when there is a particle with an uid that already exists in the
+            container, or a code without a name.
+
         """
-        if particle.uid is not None and self.has_particle(particle.uid):
-            raise Exception('Duplicated particle! {}'.format(particle.uid))
-        cdef c_ncad.CParticleInfo part_info
-        self._matchFromParticle(particle, part_info)
-        self.thisptr.AddParticle(part_info)
-        return particle.uid
+        if uids is None:
+            uids = uid_array([uuid.uuid4() for i in range(len(species))])
+        uids = uid_array(uids)
+        self._set_particle_arrays(uids, coordinates, species, species_names,
+                                  labels, label_names, False)
+        return uids
 
     def add_bonds(self, iterable):  # pragma: no cover
         """Adds a set of bonds to the container.
@@ -193,7 +277,7 @@ cdef class _NCadParticles:
             raise Exception('Duplicated bond! {}'.format(bond.uid))
         cdef c_ncad.CBondInfo bond_info
         self._matchFromBond(bond, bond_info)
-        self.thisptr.AddBond(bond_info)
+        self.index.AddBond(bond_info)
         return bond.uid
 
     def update_particles(self, iterable):  # pragma: no cover
@@ -225,25 +309,73 @@ cdef class _NCadParticles:
         >>> part_container.update_particles([part1, part2])
 
         """
-        for particle in iterable:
-            self._update_particle(particle)
+        self._set_particles(list(iterable), True)
+
+    def update_particle_arrays(self, uids, coordinates, species,
+                               species_names, labels=None, label_names=None):
+        """Updates particles given as arrays, like add_particle_arrays.
 
-    def _update_particle(self, particle):
-        """Updates the particle inside the container.
+        Nothing is updated if any of the particles does not exist.
 
         Parameters
         ----------
-        particle : Particle
-            the particle to replace
+        uids : array_like of uint8
+            n x 16 bytes of the uids of the particles (see uid_array).
+        coordinates, species, species_names, labels, label_names :
+            the new data of the particles, as in add_particle_arrays.
 
         Raises
         ------
-        Exception when the particle doesn't exists in the container.
+        Exception :
+            If any particle does not exist.
 
         """
-        cdef c_ncad.CParticleInfo part_info
-        self._matchFromParticle(particle, part_info)
-        self.thisptr.UpdateParticle(part_info)
+        self._set_particle_arrays(uid_array(uids), coordinates, species,
+                                  species_names, labels, label_names, True)
+
+    def get_particle_arrays(self, uids):
+        """Returns the data of some particles as arrays, without Particle
+        objects.
+
+        Parameters
+        ----------
+        uids : array_like of uint8
+            n x 16 bytes of the uids of the particles (see uid_array).
+
+        Returns
+        -------
+        A tuple (coordinates, species, species_names, labels, label_names,
+        occupancies), as the parameters of add_particle_arrays.
+
+        Raises
+        ------
+        Exception :
+            If any particle does not exist.
+
+        """
+        cdef unsigned char[:, ::1] c_uids = uid_array(uids)
+        cdef c_ncad.DWORD n = c_uids.shape[0]
+        coordinates = numpy.empty((n, 3))
+        species = numpy.empty(n, numpy.intc)
+        labels = numpy.empty(n, numpy.intc)
+        occupancies = numpy.empty(n)
+        cdef double[:, ::1] c_xyz = coordinates
+        cdef int[::1] c_species = species
+        cdef int[::1] c_labels = labels
+        cdef double[::1] c_occupancies = occupancies
+        cdef c_ncad.CSymbolTable species_names
+        cdef c_ncad.CSymbolTable label_names
+        cdef const char *err = NULL
+        if n > 0:
+            with nogil:
+                err = self.index.GetParticles(n, &c_uids[0, 0], &c_xyz[0, 0],
+                                              &c_species[0], &c_labels[0],
+                                              &c_occupancies[0],
+                                              species_names, label_names)
+        if err != NULL:
+            raise Exception(err)
+        return (coordinates, species, _symbol_names(species_names), labels,
+                _symbol_names(label_names), occupancies)
 
     def update_bonds(self, iterable):  # pragma: no cover
         """Updates a set of bonds from the provided iterable.
@@ -294,7 +426,7 @@ cdef class _NCadParticles:
         """
         cdef c_ncad.CBondInfo bond_info
         self._matchFromBond(bond, bond_info)
-        self.thisptr.UpdateBond(bond_info)
+        self.index.UpdateBond(bond_info)
 
     def get_particle(self, uid):
         """Returns a copy of the requested particle.
@@ -314,6 +446,8 @@ cdef class _NCadParticles:
 
         """
         cdef c_ncad.CParticleInfo *part_info = NULL
+        if not self.index.HasParticle(uid.bytes):
+            raise Exception("Particle {0} not found!".format(uid))
         part_info = self.thisptr.GetParticleInfo(uid.hex)
         if part_info is not NULL:
             res = p.Particle((part_info.x, part_info.y, part_info.z),
@@ -344,6 +478,8 @@ cdef class _NCadParticles:
 
         """
         cdef c_ncad.CBondInfo *bond_info = NULL
+        if not self.index.HasBond(uid.bytes):
+            raise Exception("Bond {0} not found!".format(uid))
         bond_info = self.thisptr.GetBondInfo(uid.hex)
         if bond_info is not NULL:
             id1 = uuid.UUID(hex=bond_info.atom1)
@@ -380,23 +516,33 @@ cdef class _NCadParticles:
         >>> particles.remove_particles([uid1, uid2])
 
         """
-        for uid in uids:
-            self._remove_particle(uid)
+        self.remove_particle_arrays(uid_array(uids))
+
+    def remove_particle_arrays(self, uids):
+        """Removes the particles of some uids from the container.
 
-    def _remove_particle(self, uid):
-        """Deletes the particle from the container.
+        Nothing is removed if any of the particles does not exist or is
+        repeated.
 
         Parameters
         ----------
-        uid : uuid.UUID
-            id of the particle
+        uids : array_like of uint8
+            n x 16 bytes of the uids of the particles (see uid_array).
 
         Raises
         ------
-        Exception if the particle doesn't exists.
+        Exception :
+            If any particle does not exist or is repeated.
 
         """
-        self.thisptr.RemoveParticle(uid.hex)
+        cdef unsigned char[:, ::1] c_uids = uid_array(uids)
+        cdef c_ncad.DWORD n = c_uids.shape[0]
+        cdef const char *err = NULL
+        if n > 0:
+            with nogil:
+                err = self.index.RemoveParticles(n, &c_uids[0, 0])
+        if err != NULL:
+            raise Exception(err)
 
     def remove_bonds(self, uids):  # pragma: no cover
         """Remove the bonds with the provided uids.
@@ -434,7 +580,7 @@ cdef class _NCadParticles:
         Exception if the bond doesn't exists.
 
         """
-        self.thisptr.RemoveBond(uid.hex)
+        self.index.RemoveBond(uid.bytes)
 
     def has_particle(self, id):
         """Indicates if the particle with the given id is in the container.
@@ -449,7 +595,7 @@ cdef class _NCadParticles:
         True if the particle exists, false otherwise.
 
         """
-        return self.thisptr.HasParticle(id.hex)
+        return self.index.HasParticle(id.bytes)
 
     def has_bond(self, id):
         """Indicates if the bond with the given id is in the container.
@@ -464,7 +610,7 @@ cdef class _NCadParticles:
         True if the bond exists, false otherwise.
 
         """
-        return self.thisptr.HasBond(id.hex)
+        return self.index.HasBond(id.bytes)
 
     def iter_particles(self, uids=None):
         """Iterates over the given particles of the container; if parameter is
@@ -661,6 +807,72 @@ cdef class _NCadParticles:
         part_info.label = p_from.data[CUBA.LABEL]
         part_info.occupancy = 1
 
+    cdef _set_particles(self, particles, bint update):
+        """Adds or updates particles through the arrays of their data."""
+        species_codes = {}
+        label_codes = {}
+        species = [species_codes.setdefault(
+                       particle.data[CUBA.CHEMICAL_SPECIE], len(species_codes))
+                   for particle in particles]
+        labels = [label_codes.setdefault(
+                      particle.data[CUBA.LABEL], len(label_codes))
+                  for particle in particles]
+        species_names = sorted(species_codes, key=species_codes.__getitem__)
+        label_names = sorted(label_codes, key=label_codes.__getitem__)
+        coordinates = numpy.array([particle.coordinates
+                                   for particle in particles],
+                                  dtype=numpy.double).reshape(-1, 3)
+        self._set_particle_arrays(
+            uid_array([particle.uid for particle in particles]), coordinates,
+            species, species_names, labels, label_names, update)
+
+    cdef _set_particle_arrays(self, uids, coordinates, species, species_names,
+                              labels, label_names, bint update):
+        """Adds or updates particles given as arrays, without the GIL."""
+        if labels is None:
+            labels, label_names = species, species_names
+        cdef unsigned char[:, ::1] c_uids = uids
+        cdef double[:, ::1] c_xyz = numpy.require(
+            coordinates, numpy.double, ['C', 'W']).reshape(-1, 3)
+        cdef int[::1] c_species = numpy.require(species, numpy.intc,
+                                                ['C', 'W'])
+        cdef int[::1] c_labels = numpy.require(labels, numpy.intc, ['C', 'W'])
+        cdef vector[string] c_species_names = species_names
+        cdef vector[string] c_label_names = label_names
+        cdef c_ncad.DWORD n = c_uids.shape[0]
+        cdef const char *err = NULL
+        if (c_xyz.shape[0] != n or c_species.shape[0] != n or
+                c_labels.shape[0] != n):
+            raise ValueError('The arrays of the particles differ in length')
+        if n == 0:
+            return
+        with nogil:
+            if update:
+                err = self.index.UpdateParticles(
+                    n, &c_uids[0, 0], &c_xyz[0, 0], &c_species[0],
+                    &c_labels[0], c_species_names, c_label_names)
+            else:
+                err = self.index.AddParticles(
+                    n, &c_uids[0, 0], &c_xyz[0, 0], &c_species[0],
+                    &c_labels[0], c_species_names, c_label_names)
+        if err != NULL:
+            raise Exception(err)
+
+    def _get_particles(self, uids):
+        """Returns the particles of some uids, read in bulk."""
+        (coordinates, species, species_names, labels, label_names,
+         occupancies) = self.get_particle_arrays(uid_array(uids))
+        res = []
+        for uid, xyz, specie, label, occupancy in zip(
+                uids, coordinates.tolist(), species.tolist(), labels.tolist(),
+                occupancies.tolist()):
+            particle = p.Particle(tuple(xyz), uid)
+            particle.data[CUBA.LABEL] = label_names[label]
+            particle.data[CUBA.CHEMICAL_SPECIE] = species_names[specie]
+            particle.data[CUBA.OCCUPANCY] = occupancy
+            res.append(particle)
+        return res
+
     cdef _matchToParticle(self, c_ncad.CParticleInfo & part_info, p_to):
         p_to.uid = uuid.UUID(hex=part_info.id)
         # p_to.uid = uuid.UUID(hex=id)
@@ -683,19 +895,21 @@ cdef class _NCadParticles:
         pass
 
     def _iter_some_particles(self, cur_ids):
+        # The particles are read from nCad in batches
+        batch = []
         for cur_id in cur_ids:
-            try:
-                res = self.get_particle(cur_id)
-                yield res
-            except KeyError:
-                raise KeyError('id {} not found!'.format(cur_id))
+            batch.append(cur_id)
+            if len(batch) == _PARTICLE_BATCH:
+                for particle in self._get_particles(batch):
+                    yield particle
+                batch = []
+        for particle in self._get_particles(batch):
+            yield particle
 
     def _iter_all_particles(self):
-        for cur_element in self.thisptr.particles:
-            cur_id = cur_element.first
-            id = uuid.UUID(cur_id)
-            res = self.get_particle(id)
-            yield res
+        cur_ids = [uuid.UUID(cur_element.first)
+                   for cur_element in self.thisptr.particles]
+        return self._iter_some_particles(cur_ids)
 
     def _iter_some_bonds(self, cur_ids):
         for cur_id in cur_ids:
@@ -722,6 +936,598 @@ cdef class _NCadParticles:
     name = property(_get_name, _set_name)
 
 
+cdef class _AssemblyBuffer:
+    """Read only buffer over an array of an AssemblySnapshot.
+
+    The NumPy arrays made from it keep it, and so the snapshot that owns
+    the memory, alive.
+
+    """
+    cdef object owner
+    cdef const void *data
+    cdef int ndim
+    cdef Py_ssize_t shape[2]
+    cdef Py_ssize_t strides[2]
+    cdef Py_ssize_t itemsize
+    cdef bytes format
+
+    def __getbuffer__(self, Py_buffer *buffer, int flags):
+        if flags & PyBUF_WRITABLE:
+            raise BufferError('The assembly arrays are read only')
+        buffer.buf = <void *>self.data
+        buffer.obj = self
+        buffer.len = self.shape[0] * self.shape[1] * self.itemsize
+        buffer.readonly = 1
+        buffer.itemsize = self.itemsize
+        buffer.format = self.format
+        buffer.ndim = self.ndim
+        buffer.shape = self.shape
+        buffer.strides = self.strides
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+
+    def __releasebuffer__(self, Py_buffer *buffer):
+        pass
+
+
+cdef _assembly_array(owner, const void *data, Py_ssize_t rows,
+                     Py_ssize_t columns, bytes format, Py_ssize_t itemsize):
+    """Returns a NumPy array over the memory of an AssemblySnapshot, of one
+    dimension if columns is 0."""
+    if data == NULL:
+        shape = (0, columns) if columns else (0,)
+        return numpy.empty(shape, dtype=numpy.dtype(format))
+    cdef _AssemblyBuffer buf = _AssemblyBuffer()
+    buf.owner = owner
+    buf.data = data
+    buf.ndim = 2 if columns else 1
+    buf.shape[0] = rows
+    buf.shape[1] = columns if columns else 1
+    buf.strides[0] = buf.shape[1] * itemsize
+    buf.strides[1] = itemsize
+    buf.itemsize = itemsize
+    buf.format = format
+    return numpy.asarray(buf)
+
+
+cdef list _symbol_names(const c_ncad.CSymbolTable &table):
+    cdef c_ncad.DWORD i
+    return [table.GetName(i) for i in range(table.GetSize())]
+
+
+cdef class AssemblySnapshot:
+    """Atoms and bonds of the processed assembly as NumPy arrays.
+
+    The arrays are read only views of the memory of the adapter, so there is
+    no Python object per atom. The particles are created only when they are
+    asked for, by get_particle or iter_particles.
+
+    Attributes
+    ----------
+    ids : numpy.ndarray of uint64
+        internal ids of the atoms.
+    uids : numpy.ndarray of uint8
+        n x 16 bytes of the name based uids of the atoms, the same of run.
+    coordinates : numpy.ndarray of float64
+        n x 3 coordinates of the atoms.
+    species : numpy.ndarray of uint16
+        index in species_names of the chemical specie of each atom.
+    labels : numpy.ndarray
+        index in label_names of the label of each atom.
+    occupancies : numpy.ndarray of float64
+        occupancy of each atom.
+    components : numpy.ndarray
+        index in component_names of the component of each atom.
+    bonds : numpy.ndarray
+        m x 2 indexes of the atoms of each bond, the lower first.
+    bond_uids : numpy.ndarray of uint8
+        m x 16 bytes of the name based uids of the bonds, the same of run.
+    species_names, label_names, component_names : list of str
+        names of the codes of the atoms.
+
+    """
+    cdef c_ncad.CAssemblyArrays *thisptr
+    cdef readonly object ids
+    cdef readonly object uids
+    cdef readonly object coordinates
+    cdef readonly object species
+    cdef readonly object labels
+    cdef readonly object occupancies
+    cdef readonly object components
+    cdef readonly object bonds
+    cdef readonly object bond_uids
+    cdef readonly list species_names
+    cdef readonly list label_names
+    cdef readonly list component_names
+
+    def __cinit__(self):
+        """Cython constructor."""
+        self.thisptr = new c_ncad.CAssemblyArrays()
+
+    def __dealloc__(self):
+        """Cython destructor."""
+        del self.thisptr
+        self.thisptr = NULL
+
+    cdef _load(self, c_ncad.CNCadSimphony *ncad, order, workers, namespace):
+        """Reads the processed assembly of nCad and makes the arrays, with
+        the uids of the atoms and bonds in a namespace."""
+        ncad.GetAssemblyArrays(deref(self.thisptr), _ATOM_ORDERS[order],
+                               workers)
+        cdef c_ncad.DWORD n = self.thisptr.GetNAtoms()
+        cdef c_ncad.DWORD m = self.thisptr.GetNBonds()
+        self.ids = _assembly_array(self, self.thisptr.GetIDs(), n, 0,
+                                   b'Q', sizeof(unsigned long long))
+        self.uids = numpy.empty((n, 16), numpy.uint8)
+        cdef unsigned char[:, ::1] c_uids = self.uids
+        cdef const unsigned char *c_namespace = namespace
+        cdef const unsigned long long *c_ids = self.thisptr.GetIDs()
+        cdef c_ncad.DWORD c_workers = workers
+        cdef const char *err = NULL
+        if n > 0:
+            with nogil:
+                err = ncad.MakeAssemblyUuids(c_namespace, n, c_ids,
+                                             &c_uids[0, 0], c_workers)
+        if err != NULL:
+            raise Exception(err)
+        self.uids.flags.writeable = False
+        self.coordinates = _assembly_array(self, self.thisptr.GetCoordinates(),
+                                           n, 3, b'd', sizeof(double))
+        self.species = _assembly_array(self, self.thisptr.GetSpecies(), n, 0,
+                                       b'H', sizeof(unsigned short))
+        self.labels = _assembly_array(self, self.thisptr.GetLabels(), n, 0,
+                                      b'L', sizeof(c_ncad.DWORD))
+        self.occupancies = _assembly_array(self,
+                                           self.thisptr.GetOccupancies(), n,
+                                           0, b'd', sizeof(double))
+        self.components = _assembly_array(self, self.thisptr.GetComponents(),
+                                          n, 0, b'L', sizeof(c_ncad.DWORD))
+        self.bonds = _assembly_array(self, self.thisptr.GetBondAtoms(), m, 2,
+                                     b'L', sizeof(c_ncad.DWORD))
+        self.bond_uids = _bond_uid_bytes(
+            namespace, self.uids[self.bonds[:, 0]].tostring(),
+            self.uids[self.bonds[:, 1]].tostring(), workers)
+        self.bond_uids.flags.writeable = False
+        self.species_names = _symbol_names(self.thisptr.GetSpeciesNames())
+        self.label_names = _symbol_names(self.thisptr.GetLabelNames())
+        self.component_names = _symbol_names(
+            self.thisptr.GetComponentNames())
+
+    def __len__(self):
+        """Returns the number of atoms."""
+        return self.thisptr.GetNAtoms()
+
+    def get_particle(self, index):
+        """Returns a particle with the data of an atom.
+
+        The particle is created on each call, with the same uid for the
+        same atom.
+
+        Parameters
+        ----------
+        index : int
+            index of the atom in the arrays.
+
+        Raises
+        ------
+        IndexError:
+            If there is no atom with the index.
+
+        """
+        cdef long n = self.thisptr.GetNAtoms()
+        cdef long i = index
+        if i < 0:
+            i += n
+        if not 0 <= i < n:
+            raise IndexError('No atom with index {}'.format(index))
+        uid = uuid.UUID(bytes=self.uids[i].tostring())
+        cdef const double *xyz = self.thisptr.GetCoordinates() + 3 * i
+        particle = p.Particle(uid=uid, coordinates=(xyz[0], xyz[1], xyz[2]))
+        particle.data[CUBA.CHEMICAL_SPECIE] = self.species_names[
+            self.thisptr.GetSpecies()[i]]
+        particle.data[CUBA.LABEL] = self.label_names[
+            self.thisptr.GetLabels()[i]]
+        particle.data[CUBA.OCCUPANCY] = self.thisptr.GetOccupancies()[i]
+        return particle
+
+    def find_in_box(self, lower, upper):
+        """Returns the indexes of the atoms inside a box, including its faces.
+
+        The atoms are found with a grid built by the first query, so the
+        queries do not scan all the atoms.
+
+        Parameters
+        ----------
+        lower, upper : sequence of three floats
+            lower and upper corners of the box.
+
+        Returns
+        -------
+        numpy.ndarray
+            indexes of the atoms in the arrays, in ascending order.
+
+        """
+        cdef double c_lower[3]
+        cdef double c_upper[3]
+        for k in range(3):
+            c_lower[k] = lower[k]
+            c_upper[k] = upper[k]
+        cdef vector[c_ncad.DWORD] indexes
+        self.thisptr.FindInBox(c_lower, c_upper, indexes)
+        return numpy.array(indexes, dtype=numpy.intp)
+
+    def find_in_radius(self, center, radius):
+        """Returns the indexes of the atoms inside a sphere, including its
+        surface, see find_in_box.
+
+        Parameters
+        ----------
+        center : sequence of three floats
+            center of the sphere.
+        radius : float
+            radius of the sphere.
+
+        Returns
+        -------
+        numpy.ndarray
+            indexes of the atoms in the arrays, in ascending order.
+
+        """
+        cdef double c_center[3]
+        for k in range(3):
+            c_center[k] = center[k]
+        cdef vector[c_ncad.DWORD] indexes
+        self.thisptr.FindInRadius(c_center, radius, indexes)
+        return numpy.array(indexes, dtype=numpy.intp)
+
+    def iter_particles(self):
+        """Iterates over the particles of all the atoms, see get_particle.
+
+        The arrays are read in batches, so only the particles of a batch are
+        in memory at once.
+
+        """
+        cdef c_ncad.DWORD n = self.thisptr.GetNAtoms()
+        make_uid = uuid.UUID
+        for begin in range(0, n, _PARTICLE_BATCH):
+            end = min(begin + _PARTICLE_BATCH, n)
+            uids = self.uids[begin:end].tostring()
+            coordinates = self.coordinates[begin:end].tolist()
+            species = self.species[begin:end].tolist()
+            labels = self.labels[begin:end].tolist()
+            occupancies = self.occupancies[begin:end].tolist()
+            for i in range(end - begin):
+                particle = p.Particle(
+                    uid=make_uid(bytes=uids[16 * i:16 * i + 16]),
+                    coordinates=tuple(coordinates[i]))
+                particle.data[CUBA.CHEMICAL_SPECIE] = self.species_names[
+                    species[i]]
+                particle.data[CUBA.LABEL] = self.label_names[labels[i]]
+                particle.data[CUBA.OCCUPANCY] = occupancies[i]
+                yield particle
+
+
+cdef long _find_uid(c_ncad.CIdIndex *index, bint *indexed, uids,
+                    uid) except? -1:
+    """Returns the position of a uid in an n x 16 array of uids, or -1 if it
+    is not there. The index of the positions is built by the first call,
+    which sets indexed."""
+    cdef c_ncad.DWORD n = len(uids)
+    cdef c_ncad.DWORD i
+    cdef const unsigned char *c_uids
+    if not indexed[0]:
+        data = uids.tostring()
+        c_uids = data
+        index.Clear()
+        index.Reserve(n)
+        for i in range(n):
+            index.Set(i, c_uids + 16 * i)
+        indexed[0] = True
+    cdef const unsigned long long *position = index.FindID(uid.bytes)
+    return -1 if position == NULL else position[0]
+
+
+cdef class AssemblyParticles:
+    """Read only particle container over the arrays of an AssemblySnapshot,
+    returned by nCad.run(lazy=True).
+
+    It implements the ABCParticles interface without a Python object per
+    atom or bond: the particles and bonds are created when they are asked
+    for, and the uids are found through indexes of C++ built on the first
+    search. The uids of the bonds are those of the snapshot, the same of
+    run.
+
+    Attributes
+    ----------
+    snapshot : AssemblySnapshot
+        the arrays of the assembly.
+    bond_uids : numpy.ndarray of uint8
+        m x 16 bytes of the uids of the bonds, in the order of
+        snapshot.bonds.
+    particle_index, bond_index : CIdIndex pointer
+        indexes between the positions in the arrays and the uids.
+    particles_indexed, bonds_indexed : bint
+        the indexes were built.
+    name : str
+        name of the container.
+    data : DataContainer
+        data attributes of the container.
+
+    """
+    cdef readonly AssemblySnapshot snapshot
+    cdef readonly object bond_uids
+    cdef c_ncad.CIdIndex *particle_index
+    cdef c_ncad.CIdIndex *bond_index
+    cdef bint particles_indexed
+    cdef bint bonds_indexed
+    cdef public object name
+    cdef public object data
+
+    def __cinit__(self, AssemblySnapshot snapshot):
+        """Cython constructor.
+
+        Parameters
+        ----------
+        snapshot : AssemblySnapshot
+            the arrays of the assembly.
+
+        """
+        self.snapshot = snapshot
+        self.bond_uids = snapshot.bond_uids
+        self.particle_index = new c_ncad.CIdIndex()
+        self.bond_index = new c_ncad.CIdIndex()
+        self.name = '__ASSEMBLY__'
+        self.data = DataContainer()
+
+    def __dealloc__(self):
+        """Cython destructor."""
+        del self.particle_index
+        self.particle_index = NULL
+        del self.bond_index
+        self.bond_index = NULL
+
+    # Common ABC interface ====================================================
+    # =========================================================================
+    def add_particles(self, iterable):
+        self._read_only()
+
+    def add_bonds(self, iterable):
+        self._read_only()
+
+    def update_particles(self, iterable):
+        self._read_only()
+
+    def update_bonds(self, iterable):
+        self._read_only()
+
+    def remove_particles(self, uids):
+        self._read_only()
+
+    def remove_bonds(self, uids):
+        self._read_only()
+
+    def get_particle(self, uid):
+        """Returns a particle of the assembly.
+
+        Parameters
+        ----------
+        uid : uuid.UUID
+            id of the requested particle.
+
+        Raises
+        ------
+        KeyError when the particle is not in the assembly.
+
+        """
+        cdef long i = _find_uid(self.particle_index, &self.particles_indexed,
+                                self.snapshot.uids, uid)
+        if i < 0:
+            raise KeyError("Particle {0} not found!".format(uid))
+        return self.snapshot.get_particle(i)
+
+    def get_bond(self, uid):
+        """Returns a bond of the assembly.
+
+        Parameters
+        ----------
+        uid : uuid.UUID
+            id of the requested bond.
+
+        Raises
+        ------
+        KeyError when the bond is not in the assembly.
+
+        """
+        cdef long i = _find_uid(self.bond_index, &self.bonds_indexed,
+                                self.bond_uids, uid)
+        if i < 0:
+            raise KeyError("Bond {0} not found!".format(uid))
+        return self._get_bond(i, uid)
+
+    def has_particle(self, id):
+        """Indicates if the particle with the given id is in the assembly."""
+        return _find_uid(self.particle_index, &self.particles_indexed,
+                         self.snapshot.uids, id) >= 0
+
+    def has_bond(self, id):
+        """Indicates if the bond with the given id is in the assembly."""
+        return _find_uid(self.bond_index, &self.bonds_indexed,
+                         self.bond_uids, id) >= 0
+
+    def iter_particles(self, uids=None):
+        """Iterates over the given particles of the assembly; if parameter is
+        omitted, it will iterate over all of them, in batches.
+
+        Parameters
+        ----------
+        uids : iterable
+            sequence with the uids to iterate.
+
+        Raises
+        ------
+        KeyError if any of the uids is not in the assembly.
+
+        """
+        if uids:
+            return (self.get_particle(uid) for uid in uids)
+        else:
+            return self.snapshot.iter_particles()
+
+    def iter_bonds(self, uids=None):
+        """Iterates over the given bonds of the assembly; if parameter is
+        omitted, it will iterate over all of them.
+
+        Parameters
+        ----------
+        uids : iterable
+            sequence with the uids to iterate.
+
+        Raises
+        ------
+        KeyError if any of the uids is not in the assembly.
+
+        """
+        if uids:
+            return (self.get_bond(uid) for uid in uids)
+        else:
+            return self._iter_all_bonds()
+
+    def count_of(self, item_type):
+        """ Return the count of item_type in the assembly.
+
+        Parameter
+        ---------
+        item_type : CUDSItem
+           The CUDSItem enum of the type of the items to return the count of.
+
+        Raises
+        ------
+        TypeError :
+            If the type of the item is not supported.
+
+        """
+        if item_type == CUDSItem.PARTICLE:
+            return len(self.snapshot)
+        elif item_type == CUDSItem.BOND:
+            return len(self.bond_uids)
+        else:
+            raise TypeError('type {0} not supported'.format(item_type))
+
+    def _read_only(self):
+        raise Exception('The assembly of nCad is read only')
+
+    def _get_bond(self, i, uid):
+        atoms = self.snapshot.bonds[i]
+        uids = self.snapshot.uids
+        return p.Bond((uuid.UUID(bytes=uids[atoms[0]].tostring()),
+                       uuid.UUID(bytes=uids[atoms[1]].tostring())), uid)
+
+    def _iter_all_bonds(self):
+        bond_uids = self.bond_uids.tostring()
+        for i in range(len(self.bond_uids)):
+            uid = uuid.UUID(bytes=bond_uids[16 * i:16 * i + 16])
+            yield self._get_bond(i, uid)
+
+
+ABCParticles.register(AssemblyParticles)
+
+
+cdef _run_job(c_ncad.CAsyncJob *job):
+    """Runs a job of nCad on its worker thread and waits for its end with
+    the GIL released."""
+    cdef const char *err = job.Start()
+    if err == NULL:
+        with nogil:
+            job.Wait(c_ncad.INFINITE)
+        err = job.GetError()
+    if err != NULL:
+        raise Exception(err)
+
+
+cdef class AssemblyJob:
+    """Handle of the generation of the assembly started by nCad.run_async.
+
+    nCad processes the components and reads the atoms on a worker thread,
+    without the GIL. The particles of the result are created when result is
+    called, on the calling thread. The engine must not be changed until the
+    job is done.
+
+    """
+    cdef c_ncad.CAssemblyJob *thisptr
+    cdef c_ncad.CNCadParticleContainer *assembly
+    cdef nCad engine
+    cdef object _result
+
+    def __dealloc__(self):
+        """Cython destructor, which waits for the end of the job with the GIL
+        released."""
+        cdef c_ncad.CAssemblyJob *job = self.thisptr
+        self.thisptr = NULL
+        with nogil:
+            del job
+        del self.assembly
+        self.assembly = NULL
+
+    cdef _start(self, nCad engine):
+        """Starts processing the components of an engine."""
+        self.engine = engine
+        self.assembly = new c_ncad.CNCadParticleContainer()
+        self.assembly.name = '__ASSEMBLY__'
+        self.thisptr = new c_ncad.CAssemblyJob(
+            deref(engine.thisptr), engine._workers, engine._bond_max_length,
+            self.assembly)
+        cdef const char *err = self.thisptr.Start()
+        if err != NULL:
+            raise Exception(err)
+
+    def done(self):
+        """Returns True if nCad finished, without waiting."""
+        return self.thisptr.IsDone()
+
+    def wait(self, timeout=None):
+        """Waits until nCad finishes, with the GIL released.
+
+        Parameters
+        ----------
+        timeout : float
+            the longest time to wait in seconds, by default until the end.
+
+        Returns
+        -------
+        True if nCad finished.
+
+        """
+        cdef c_ncad.DWORD milliseconds = c_ncad.INFINITE
+        cdef bint done
+        if timeout is not None:
+            milliseconds = max(int(timeout * 1000), 0)
+        with nogil:
+            done = self.thisptr.Wait(milliseconds)
+        return done
+
+    def result(self):
+        """Waits until nCad finishes and returns the assembly, as run.
+
+        Returns
+        -------
+        A ParticleContainer of Simphony with the processed components.
+
+        Raises
+        ------
+        Exception:
+            If nCad failed to process the components.
+
+        """
+        cdef const char *err
+        if self._result is None:
+            self.wait()
+            err = self.thisptr.GetError()
+            if err != NULL:
+                raise Exception(err)
+            self._result = self.engine._newAssembly(self.assembly)
+        return self._result
+
+
 cdef class nCad:
     """Wrapper class for nCad engine.
 
@@ -735,6 +1541,28 @@ cdef class nCad:
         dictionary of cells inside nCad
     _session_name : str
         the name of the current started session / project
+    _workers : int
+        number of worker threads used by the adapter in run, to bond and
+        read the assembly atoms (1 means serial, 0 one worker per processor)
+    _bond_max_length : float
+        when positive, run bonds all the assembly atoms closer than this
+        distance
+    _atom_order : str
+        order of the atoms returned by run: None (the order of nCad),
+        'morton' or 'hilbert' (along a space filling curve)
+    _uid_namespace : uuid.UUID
+        namespace of the name based uids of the atoms returned by run
+    assembly_ids : CIdIndex pointer
+        index between the internal ids and the uids of the atoms of the
+        assembly returned by run
+    _job : AssemblyJob
+        the last job started by run_async
+    _open_cursors : int
+        number of iterations of iter_assembly_atoms and iter_assembly_bonds
+        that are open, whose cursors read the assembly on their threads
+    _assembly_particle_uids, _assembly_bond_uids : list of uuid.UUID
+        uids of the atoms and bonds that the last run added to the
+        components, which are removed before processing again
     CM : dictionary
         Computational method
     BC : dictionary
@@ -751,6 +1579,15 @@ cdef class nCad:
     cdef object _components
     cdef object _cells
     cdef string _session_name
+    cdef unsigned int _workers
+    cdef double _bond_max_length
+    cdef object _atom_order
+    cdef object _uid_namespace
+    cdef c_ncad.CIdIndex *assembly_ids
+    cdef AssemblyJob _job
+    cdef unsigned int _open_cursors
+    cdef object _assembly_particle_uids
+    cdef object _assembly_bond_uids
     cdef object _cuds
     # --------------------
     cdef object CM
@@ -772,15 +1609,40 @@ cdef class nCad:
         project : str
             the session name (project name) which ncad will use to store
             the data in physycal disk.
+        workers : int
+            number of worker threads used by the adapter to bond and read
+            the assembly atoms (default 1, serial).
+        bond_max_length : float
+            maximal length of the bonds created between the assembly atoms
+            in run (default 0, no bonds created).
+        atom_order : str
+            order of the atoms returned by run, None, 'morton' or 'hilbert'
+            (default None, the order of nCad).
+        uid_namespace : uuid.UUID
+            namespace of the uids of the atoms returned by run (default
+            the uuid5 of the project name in NCAD_NAMESPACE, or
+            NCAD_NAMESPACE itself if no project name is given, as the
+            generated names are random and would give other uids on each
+            session).
 
         """
+        self._workers = kwargs.get('workers', 1)
+        self._bond_max_length = kwargs.get('bond_max_length', 0)
+        self.set_atom_order(kwargs.get('atom_order', None))
         project_name = kwargs.get('project', None)
         if project_name == None:
             project_name = self._generate_project_name()
+            namespace = NCAD_NAMESPACE
+        else:
+            namespace = uuid.uuid5(NCAD_NAMESPACE, project_name)
         self._session_name = project_name
+        self.set_uid_namespace(kwargs.get('uid_namespace', namespace))
+        self._assembly_particle_uids = []
+        self._assembly_bond_uids = []
         if c_ncad.pCNCadSimphony is NULL:
             c_ncad.pCNCadSimphony = new c_ncad.CNCadSimphony()
         self.thisptr = c_ncad.pCNCadSimphony
+        self.assembly_ids = new c_ncad.CIdIndex()
         self.thisptr.LoadSession(self._session_name)
         self._load_cuds()
 
@@ -789,6 +1651,8 @@ cdef class nCad:
         c_ncad.delete_pointer(c_ncad.pCNCadSimphony)
         del self.thisptr
         self.thisptr = NULL
+        del self.assembly_ids
+        self.assembly_ids = NULL
 
     def _generate_project_name(self):
         """We just use a random name."""
@@ -799,6 +1663,135 @@ cdef class nCad:
     def get_project_name(self):
         return str(self._session_name)
 
+    def get_workers(self):
+        return self._workers
+
+    def set_workers(self, workers):
+        """Sets the number of worker threads used in run to bond, sort and
+        read the assembly atoms. The components themselves are always
+        processed one after the other by nCad, which is not re-entrant. The
+        resulting assembly does not depend on this value.
+
+        Parameters
+        ----------
+        workers : int
+            number of workers; 1 means serial and 0 one worker per
+            processor.
+
+        """
+        self._workers = workers
+
+    def get_bond_max_length(self):
+        return self._bond_max_length
+
+    def set_bond_max_length(self, distance):
+        """Sets the maximal length of the bonds created in run between the
+        atoms of the assembly. The atom pairs are found with a linked-cell
+        search, so the cost is linear in the number of atoms.
+
+        Parameters
+        ----------
+        distance : float
+            maximal length of the bonds; 0 means no bonds are created.
+
+        """
+        self._bond_max_length = distance
+
+    def get_atom_order(self):
+        return self._atom_order
+
+    def set_atom_order(self, order):
+        """Sets the order of the atoms returned by run and export_xyz. Along
+        a space filling curve the atoms close in space are close in the
+        output, which makes the first neighbour list and domain
+        decomposition of the simulation codes cheaper. The bonds are
+        returned in the order of their first atom.
+
+        Parameters
+        ----------
+        order : str
+            None keeps the order of nCad (by component and atom), 'morton'
+            sorts the atoms along the Z order curve and 'hilbert' along the
+            Hilbert curve, which keeps them a little closer.
+
+        Raises
+        ------
+        ValueError:
+            If the order is not one of these.
+
+        """
+        if order not in _ATOM_ORDERS:
+            raise ValueError('Unknown atom order: {}'.format(order))
+        self._atom_order = order
+
+    def get_uid_namespace(self):
+        return self._uid_namespace
+
+    def set_uid_namespace(self, namespace):
+        """Sets the namespace of the uids of the atoms returned by run. The
+        uid of an atom is made from the namespace, its component and its
+        internal id, as uuid.uuid5(namespace, struct.pack('>iQ', component,
+        id)), so processing the same assembly again in the same namespace
+        gives the same uids, which can be compared between the runs.
+
+        Parameters
+        ----------
+        namespace : uuid.UUID
+            the namespace.
+
+        Raises
+        ------
+        TypeError:
+            If the namespace is not a uuid.UUID.
+
+        """
+        if not isinstance(namespace, uuid.UUID):
+            raise TypeError('The uid namespace must be a uuid.UUID')
+        self._uid_namespace = namespace
+
+    def export_xyz(self, file_name):
+        """Writes the atoms of the assembly processed last, by run or
+        iter_assembly_atoms, to a file of XYZ format, in the atom order set.
+
+        Parameters
+        ----------
+        file_name : str
+            name of the file.
+
+        Raises
+        ------
+        Exception:
+            If the job started by run_async is not done yet.
+
+        """
+        self._check_idle()
+        cdef string name = file_name
+        self.thisptr.ExportAssemblyToXYZ(name, _ATOM_ORDERS[self._atom_order],
+                                         self._workers)
+
+    def autobond_cell(self, name, distance):
+        """Creates the bonds between all the atoms of a cell closer than the
+        given distance. Each pair of positions of the cell is bonded once,
+        and the atoms of the same position (of a site of mixed occupancy)
+        are not bonded to each other. Only the atoms inside the cell are
+        bonded, not the periodic images of the atoms in the neighbour cells.
+
+        Parameters
+        ----------
+        name : str
+            name of the cell.
+        distance : float
+            maximal length of the bonds.
+
+        Raises
+        ------
+        Exception:
+            If the cell doesn't exist.
+
+        """
+        cdef string cell_name = name
+        self.thisptr.AutobondCell(cell_name, distance, self._workers)
+
     # Common ABC interface ====================================================
     # =========================================================================
     def _load_cuds(self):
@@ -814,36 +1807,237 @@ cdef class nCad:
         """Get current CUDS instance."""
         return self._cuds
 
-    def run(self):
+    def run(self, lazy=False):
         """Run method of the nCad module.
 
         Using this, nCad will take all the particle containers of 'component'
         type inside the current session and process them in a single "assembly"
         particle container (of Simphony cuds classes) and return them.
 
+        nCad runs without the GIL, so the other Python threads keep working
+        meanwhile (see run_async).
+
+        The atoms and bonds of the assembly are also added to the components.
+        Those of the previous run are removed first, so running again gives
+        the same assembly, with the same uids, and adds it once.
+
+        Parameters
+        ----------
+        lazy : bool
+            if True, the assembly is returned as an AssemblyParticles, a read
+            only container over the arrays of run_arrays that creates the
+            particles and bonds only when they are asked for, instead of a
+            Particles container with a copy of all of them. Like in
+            run_arrays, its atoms are not added to the components.
+
         Returns
         -------
         A ParticleContainer of Simphony with the processed components.
 
         """
-        self.thisptr.ProcessAll()
-        res = p.Particles('__ASSEMBLY__')
-        cdef c_ncad.CNCadParticleContainer *assembly
-        assembly = new c_ncad.CNCadParticleContainer()
-        assembly.name = res.name # we don't need this atm
+        if lazy:
+            return AssemblyParticles(self.run_arrays())
+        return self.run_async().result()
 
-        self.thisptr.BeginAssembly()
+    def run_async(self):
+        """Starts processing the components like run, on a worker thread of
+        nCad, and returns at once.
 
-        self.thisptr.GetAssemblyAtoms(assembly)
-        self._newAtomsFromAssembly(assembly, res)
-        self.thisptr.GetAssemblyBonds(assembly)
-        self._newBondsFromAssembly(assembly, res)
+        Returns
+        -------
+        An AssemblyJob, to poll or wait for the end and get the assembly.
 
-        self.thisptr.EndAssembly()
+        Raises
+        ------
+        Exception:
+            If the previous job is not done yet.
 
-        del assembly
+        """
+        self._check_idle()
+        self._remove_assembly_from_components()
+        job = AssemblyJob()
+        job._start(self)
+        self._job = job
+        return job
+
+    def _check_idle(self):
+        """Raises an exception if the job started by run_async is not done,
+        as nCad can only process one assembly at a time, or if an iteration
+        of the assembly is open, as its cursor thread is still reading the
+        assembly in nCad while the generator is suspended."""
+        if self._job is not None and not self._job.done():
+            raise Exception('The assembly is already being processed')
+        if self._open_cursors > 0:
+            raise Exception('The assembly is being iterated')
+
+    def _remove_assembly_from_components(self):
+        """Removes from the components the atoms and bonds that the last run
+        added to them, so each run adds its own assembly once, instead of
+        adding the same uids again and processing the atoms of the previous
+        assembly as atoms of the components."""
+        particle_uids = self._assembly_particle_uids
+        bond_uids = self._assembly_bond_uids
+        self._assembly_particle_uids = []
+        self._assembly_bond_uids = []
+        for component in self._components.itervalues():
+            component.remove_bonds([uid for uid in bond_uids
+                                    if component.has_bond(uid)])
+            component.remove_particles([uid for uid in particle_uids
+                                        if component.has_particle(uid)])
+
+    cdef _newAssembly(self, c_ncad.CNCadParticleContainer *assembly):
+        """Creates the particles and bonds of the assembly, whose atoms were
+        read by an AssemblyJob."""
+        res = p.Particles('__ASSEMBLY__')
+        atom_ids = []
+        try:
+            self._newAtomsFromAssembly(assembly, res, atom_ids)
+            self._newBondsFromAssembly(assembly, res, atom_ids)
+        finally:
+            self.thisptr.EndAssembly()
+            self._invalidate_components()
         return res
 
+    cdef _invalidate_components(self):
+        """Marks the indexes of the components to be rebuilt, as the atoms
+        and bonds of the assembly are added to the components by nCad and
+        not through the indexes."""
+        cdef _NCadParticles component
+        for component in self._components.itervalues():
+            component.index.Invalidate()
+
+    def run_arrays(self):
+        """Processes the components like run, but returns the assembly as
+        NumPy arrays instead of a Particles container.
+
+        Creating a particle per atom takes most of the time of run for large
+        assemblies, while the snapshot only copies the atoms and bonds once
+        in C++ and creates the particles when they are asked for.
+
+        Returns
+        -------
+        An AssemblySnapshot, with the atoms in the atom order set.
+
+        Raises
+        ------
+        Exception:
+            If the job started by run_async is not done yet.
+
+        """
+        self._process_assembly()
+        snapshot = AssemblySnapshot()
+        (<AssemblySnapshot>snapshot)._load(self.thisptr, self._atom_order,
+                                           self._workers,
+                                           self._uid_namespace.bytes)
+        return snapshot
+
+    def iter_assembly_atoms(self, batch_size=4096):
+        """Processes the components and iterates the atoms of the assembly
+        in batches.
+
+        The atoms are read from nCad by another thread while the batches
+        are consumed, so they are not all kept in memory as by run. Until
+        the iteration ends or the generator is closed, the calls that
+        process or read the assembly raise an exception.
+
+        Parameters
+        ----------
+        batch_size : int
+            number of atoms of each batch.
+
+        Yields
+        ------
+        Lists of (id, (x, y, z), chemical specie, label) tuples.
+
+        """
+        self._process_assembly()
+        cdef c_ncad.CAtomCursor *cursor = new c_ncad.CAtomCursor(batch_size)
+        cdef c_ncad.NC_AtomSpan atoms
+        cdef const char *err
+        cdef unsigned int i, index
+        cdef bint opened = False
+        try:
+            self.thisptr.OpenAssemblyAtomCursor(deref(cursor))
+            self._open_cursors += 1
+            opened = True
+            while True:
+                with nogil:
+                    err = cursor.Next()
+                if err != NULL:
+                    raise Exception(err)
+                atoms = cursor.GetAtoms()
+                if atoms.count == 0:
+                    break
+                batch = []
+                for i in range(atoms.count):
+                    index = atoms.first + i
+                    batch.append((atoms.ids[i],
+                                  (atoms.x[i], atoms.y[i], atoms.z[i]),
+                                  atoms.pStore.GetElement(index),
+                                  atoms.pStore.GetLabel(index)))
+                yield batch
+        finally:
+            if opened:
+                self._open_cursors -= 1
+            del cursor
+
+    def iter_assembly_bonds(self, batch_size=4096):
+        """Iterates the bonds of the assembly processed last, by run or
+        iter_assembly_atoms, in batches.
+
+        Parameters
+        ----------
+        batch_size : int
+            number of bonds of each batch.
+
+        Yields
+        ------
+        Lists of (id1, id2) tuples with the ids of the bonded atoms.
+
+        Raises
+        ------
+        Exception:
+            If the job started by run_async is not done yet, or another
+            iteration of the assembly is open.
+
+        """
+        self._check_idle()
+        cdef c_ncad.CBondCursor *cursor = new c_ncad.CBondCursor(batch_size)
+        cdef c_ncad.NC_BondSpan bonds
+        cdef const char *err
+        cdef unsigned int i
+        cdef bint opened = False
+        try:
+            self.thisptr.OpenAssemblyBondCursor(deref(cursor))
+            self._open_cursors += 1
+            opened = True
+            while True:
+                with nogil:
+                    err = cursor.Next()
+                if err != NULL:
+                    raise Exception(err)
+                bonds = cursor.GetBonds()
+                if bonds.count == 0:
+                    break
+                yield [(bonds.ids1[i], bonds.ids2[i])
+                       for i in range(bonds.count)]
+        finally:
+            if opened:
+                self._open_cursors -= 1
+            del cursor
+
+    def _process_assembly(self):
+        """Processes the components in the assembly and bonds its atoms,
+        with the workers set, without the GIL."""
+        self._check_idle()
+        self._remove_assembly_from_components()
+        cdef c_ncad.CAssemblyJob *job = new c_ncad.CAssemblyJob(
+            deref(self.thisptr), self._workers, self._bond_max_length, NULL)
+        try:
+            _run_job(job)
+        finally:
+            del job
+
     def add_dataset(self, container):
         """Add a CUDS container
 
@@ -1288,7 +2482,7 @@ cdef class nCad:
         pc_to.thisptr = res
 
     cdef _newAtomsFromAssembly(self, c_ncad.CNCadParticleContainer *pc_from,
-                               pc_to):
+                               pc_to, atom_ids):
         cdef map[c_ncad.ID_TYPE, c_ncad.CNCadParticle*].iterator it
         it = pc_from.particles.begin()
         cdef map[c_ncad.ID_TYPE, c_ncad.CNCadParticle*].iterator end
@@ -1297,56 +2491,134 @@ cdef class nCad:
         cdef c_ncad.CNCadParticle *cur_particle
         cdef map[c_ncad.ID_TYPE, c_ncad.CNCadParticle*] new_particles
         cdef map[long long unsigned int, c_ncad.ID_TYPE] new_particles_reverse_ids
-        while it != end:
-            cur_particle = deref(it).second
-            particle_info = self.thisptr.GetAssemblyParticleInfo(
-                cur_particle.ID)
-            new_particle = p.Particle(coordinates=(particle_info.x,
-                                                   particle_info.y,
-                                                   particle_info.z))
-            new_particle.data[CUBA.CHEMICAL_SPECIE] = particle_info.specie
-            new_particle.data[CUBA.LABEL] = particle_info.label
-            pc_to.add_particles([new_particle])
-            # Add to the component!
-            new_id = new_particle.uid
-            # cur_particle.Simphony_ID = new_id.hex
-            simphony_id = new_id.hex
-            new_particles[simphony_id] = cur_particle
-            new_particles_reverse_ids[cur_particle.ID] = simphony_id
-            # print "HERETHERE ", simphony_id, cur_particle.ID
-            self.thisptr.ProcessAssemblyParticle(cur_particle, simphony_id)
-            inc(it)
-            c_ncad.delete_pointer(particle_info)
+        cdef vector[c_ncad.CNCadParticle*] particles
+        cdef vector[c_ncad.CParticleInfo*] infos
+        cdef c_ncad.CPointArray points
+        cdef vector[c_ncad.DWORD] order
+        cdef vector[unsigned long long] ids
+        cdef vector[unsigned char] uuids
+        cdef unsigned int i
+        cdef c_ncad.DWORD n
+        cdef const char *err = NULL
+        namespace = self._uid_namespace.bytes
+        cdef const unsigned char *c_namespace = namespace
+        # The species and labels repeat for every atom of a cell, so a single
+        # string object of each one is shared by all the particles
+        symbols = {}
+        try:
+            # The coordinates are read first to sort the atoms
+            while it != end:
+                cur_particle = deref(it).second
+                particles.push_back(cur_particle)
+                particle_info = self.thisptr.GetAssemblyParticleInfo(
+                    cur_particle.ID)
+                infos.push_back(particle_info)
+                points.x.push_back(particle_info.x)
+                points.y.push_back(particle_info.y)
+                points.z.push_back(particle_info.z)
+                inc(it)
+            c_ncad.GetSpatialOrder(points, _ATOM_ORDERS[self._atom_order],
+                                   order, self._workers)
+            # The uids are made from the internal ids all at once in C++
+            n = order.size()
+            for i in range(n):
+                ids.push_back(particles[order[i]].ID)
+            uuids.resize(16 * n)
+            if n > 0:
+                with nogil:
+                    err = self.thisptr.MakeAssemblyUuids(
+                        c_namespace, n, &ids[0], &uuids[0], self._workers)
+            if err != NULL:
+                raise Exception(err)
+            self._assembly_particle_uids = [
+                uuid.UUID(bytes=(<char *>&uuids[16 * i])[:16])
+                for i in range(n)]
+            self.assembly_ids.Clear()
+            self.assembly_ids.Reserve(n)
+            for i in range(n):
+                cur_particle = particles[order[i]]
+                particle_info = infos[order[i]]
+                new_particle = p.Particle(
+                    coordinates=(particle_info.x, particle_info.y,
+                                 particle_info.z),
+                    uid=self._assembly_particle_uids[i])
+                specie = particle_info.specie
+                label = particle_info.label
+                new_particle.data[CUBA.CHEMICAL_SPECIE] = symbols.setdefault(
+                    specie, specie)
+                new_particle.data[CUBA.LABEL] = symbols.setdefault(
+                    label, label)
+                new_particle.data[CUBA.OCCUPANCY] = particle_info.occupancy
+                pc_to.add_particles([new_particle])
+                # Add to the component!
+                new_id = new_particle.uid
+                # cur_particle.Simphony_ID = new_id.hex
+                simphony_id = new_id.hex
+                new_particles[simphony_id] = cur_particle
+                new_particles_reverse_ids[cur_particle.ID] = simphony_id
+                self.assembly_ids.Set(cur_particle.ID, &uuids[16 * i])
+                atom_ids.append(cur_particle.ID)
+                # print "HERETHERE ", simphony_id, cur_particle.ID
+                self.thisptr.ProcessAssemblyParticle(cur_particle, simphony_id)
+                c_ncad.delete_pointer(particle_info)
+                infos[order[i]] = NULL
+        finally:
+            for i in range(infos.size()):
+                c_ncad.delete_pointer(infos[i])
         pc_from.particles = new_particles
         pc_from.particles_reverse_ids = new_particles_reverse_ids
         return pc_to
 
     cdef _newBondsFromAssembly(self, c_ncad.CNCadParticleContainer *pc_from,
-                               pc_to):
-        cdef map[c_ncad.ID_TYPE, c_ncad.CNCadParticle*].iterator it1
-        it1 = pc_from.particles.begin()
-        cdef map[c_ncad.ID_TYPE, c_ncad.CNCadParticle*].iterator it2
-        end1 = pc_from.particles.end()
-        cdef map[c_ncad.ID_TYPE, c_ncad.CNCadBond*].iterator it
-        it = pc_from.bonds.begin()
-        cdef map[c_ncad.ID_TYPE, c_ncad.CNCadBond*].iterator end
-        end = pc_from.bonds.end()
-        cdef c_ncad.CNCadBond *cur_bond
-        cdef map[c_ncad.ID_TYPE, c_ncad.CNCadBond*] new_bonds
-        while it != end:
-            cur_bond = deref(it).second
-            # print cur_bond.atom1, cur_bond.atom2
-            new_bond = p.Bond(particles=(uuid.UUID(hex=cur_bond.atom1),
-                                         uuid.UUID(hex=cur_bond.atom2)))
-            pc_to.add_bonds([new_bond])
-            # Add to the component!
-            new_id = new_bond.uid
-            # cur_bond.Simphony_ID = new_id.hex
-            simphony_id = new_id.hex
-            new_bonds[simphony_id] = cur_bond
-            self.thisptr.ProcessAssemblyBond(cur_bond, simphony_id)
-            inc(it)
-        pc_from.bonds = new_bonds
+                               pc_to, atom_ids):
+        """Creates the bonds of the assembly, whose atoms are resolved to
+        their uids in C++ through assembly_ids, all at once.
+
+        atom_ids are the nCad IDs of the atoms in the order of the particles.
+        """
+        cdef c_ncad.CAssemblyBondArrays *bonds = \
+            new c_ncad.CAssemblyBondArrays()
+        cdef c_ncad.CAssemblyBondsJob *job = NULL
+        cdef c_ncad.DWORD n
+        try:
+            job = new c_ncad.CAssemblyBondsJob(deref(self.assembly_ids),
+                                               deref(bonds), self._workers)
+            _run_job(job)
+            n = bonds.GetSize()
+            if n == 0:
+                return pc_to
+            uuids1 = (<char *>bonds.GetUuids1())[:16 * n]
+            uuids2 = (<char *>bonds.GetUuids2())[:16 * n]
+            # The bonds follow the order of their first atom
+            order = numpy.arange(n)
+            if self._atom_order is not None:
+                atom_ids = numpy.array(atom_ids, numpy.uint64)
+                sorter = numpy.argsort(atom_ids)
+                positions = []
+                for ids in (<char *>bonds.GetIDs1())[:8 * n], \
+                           (<char *>bonds.GetIDs2())[:8 * n]:
+                    ids = numpy.frombuffer(ids, numpy.uint64)
+                    positions.append(sorter[numpy.searchsorted(atom_ids, ids,
+                                                               sorter=sorter)])
+                order = numpy.argsort(numpy.minimum(*positions),
+                                      kind='mergesort')
+            # The uids of the bonds are made from the uids of their atoms,
+            # so the same assembly always gets the same bonds
+            uids = _bond_uid_bytes(self._uid_namespace.bytes, uuids1, uuids2,
+                                   self._workers).tostring()
+            make_uid = uuid.UUID
+            bond_uids = [make_uid(bytes=uids[16 * i:16 * i + 16])
+                         for i in range(n)]
+            self._assembly_bond_uids = bond_uids
+            pc_to.add_bonds([p.Bond(particles=(
+                make_uid(bytes=uuids1[16 * i:16 * i + 16]),
+                make_uid(bytes=uuids2[16 * i:16 * i + 16])),
+                uid=bond_uids[i]) for i in order])
+            # Add to the components!
+            self.thisptr.ProcessAssemblyBonds(pc_from, deref(bonds), uids)
+        finally:
+            del job
+            del bonds
         return pc_to
     # =========================================================================
     # =========================================================================
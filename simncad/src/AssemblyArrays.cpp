@@ -0,0 +1,105 @@
+#include "AssemblyArrays.h"
+
+#include <map>
+
+//==============================================================================
+ERR CAssemblyArrays::Load(const NC_Wrapper &Wrapper, SpatialOrderType order, DWORD workers)
+{
+    Clear();
+    CBondStore bonds;
+    CAtomStoreCollector AtomCollector(atoms);
+    CBondStoreCollector BondCollector(bonds);
+    ERR err = Wrapper.ForEachAtom(AtomCollector);
+    if (!err)
+        err = Wrapper.ForEachBond(BondCollector);
+    if (!err)
+        err = bonds.Build(atoms);
+    if (!err)
+        err = SortSpatially(atoms, bonds, order, workers);
+    if (err)
+    {
+        Clear();
+        return err;
+    }
+    IndexAtoms(Wrapper);
+    IndexBonds(bonds);
+    return NULL;
+}
+
+void CAssemblyArrays::Clear()
+{
+    atoms.Clear();
+    coordinates.clear();
+    species.clear();
+    components.clear();
+    bondAtoms.clear();
+    speciesNames.Clear();
+    componentNames.Clear();
+    grid.Invalidate();
+}
+
+//==============================================================================
+void CAssemblyArrays::FindInBox(const double *lower, const double *upper, vector<DWORD> &indexes) const
+{
+    Vector3DBox Box;
+    Box.AddVector(lower[0], lower[1], lower[2]);
+    Box.AddVector(upper[0], upper[1], upper[2]);
+    grid.FindInBox(Box, indexes);
+}
+
+void CAssemblyArrays::FindInRadius(const double *center, double radius, vector<DWORD> &indexes) const
+{
+    grid.FindInRadius(Vector3D(center[0], center[1], center[2]), radius, indexes);
+}
+
+//==============================================================================
+void CAssemblyArrays::IndexAtoms(const NC_Wrapper &Wrapper)
+{
+    DWORD n = atoms.GetSize();
+    const CPointArray &Points = atoms.GetPoints();
+    coordinates.resize(3 * n);
+    species.resize(n);
+    components.resize(n);
+    // The element codes of the store and the component IDs of nCad are sparse, so they
+    // are renumbered, and each name is only read the first time
+    vector<DWORD> speciesCodes;
+    map<int, DWORD> componentCodes;
+    for (DWORD i = 0; i < n; i++)
+    {
+        coordinates[3 * i] = Points.x[i];
+        coordinates[3 * i + 1] = Points.y[i];
+        coordinates[3 * i + 2] = Points.z[i];
+
+        WORD code = atoms.GetElementCode(i);
+        if (code >= speciesCodes.size())
+            speciesCodes.resize(code + 1, SYMBOL_NONE);
+        if (speciesCodes[code] == SYMBOL_NONE)
+            speciesCodes[code] = speciesNames.Intern(atoms.GetElement(i));
+        species[i] = (WORD)speciesCodes[code];
+
+        id_t id = atoms.GetID(i);
+        int componentID = Wrapper.GetComponentIDByAtomID(id);
+        map<int, DWORD>::iterator it = componentCodes.find(componentID);
+        if (it == componentCodes.end())
+            it = componentCodes.insert(make_pair(componentID,
+                componentNames.Intern(Wrapper.GetComponentNameByAtomID(id)))).first;
+        components[i] = it->second;
+    }
+}
+
+void CAssemblyArrays::IndexBonds(const CBondStore &bonds)
+{
+    bondAtoms.reserve(2 * bonds.GetNBonds());
+    // Every bond is in the lists of both atoms, it is taken from the one of the lower atom;
+    // a bond of an atom with itself is only in its list, and counted by the store as well
+    for (DWORD i = 0; i < bonds.GetNAtoms(); i++)
+        for (DWORD k = 0; k < bonds.GetDegree(i); k++)
+        {
+            DWORD j = bonds.GetNeighbour(i, k);
+            if (i <= j)
+            {
+                bondAtoms.push_back(i);
+                bondAtoms.push_back(j);
+            }
+        }
+}
@@ -0,0 +1,92 @@
+#include "NCadSimphonyWrapper.h"
+#include "AtomStore.h"
+#include "BondStore.h"
+#include "Cursors.h"
+#include "SpatialOrder.h"
+#include "AssemblyArrays.h"
+#include "AssemblyBonds.h"
+#include "Uuid.h"
+#include "AtomUuids.h"
+
+#include <stdexcept>
+#include <cstdio>
+
+static const char *pERRAtomUuids = "Cannot make the UUIDs of the assembly atoms";
+
+void CNCadSimphony::GetAssemblyAtomStore(CAtomStore &store)
+{
+    CAtomStoreCollector Collector(store);
+    ERR err = GetWrapperInterface()->ForEachAtom(Collector);
+    if (err)
+        throw runtime_error(err);
+}
+
+void CNCadSimphony::OpenAssemblyAtomCursor(CAtomCursor &cursor)
+{
+    ERR err = cursor.Open(*GetWrapperInterface());
+    if (err)
+        throw runtime_error(err);
+}
+
+void CNCadSimphony::OpenAssemblyBondCursor(CBondCursor &cursor)
+{
+    ERR err = cursor.Open(*GetWrapperInterface());
+    if (err)
+        throw runtime_error(err);
+}
+
+void CNCadSimphony::ExportAssemblyToXYZ(const string &fileName, SpatialOrderType order, DWORD workers)
+{
+    CAtomStore atoms;
+    CBondStore bonds;
+    GetAssemblyAtomStore(atoms);
+    ERR err = SortSpatially(atoms, bonds, order, workers);
+    if (err)
+        throw runtime_error(err);
+    FILE *pFile = fopen(fileName.c_str(), "w");
+    if (!pFile)
+        throw runtime_error("Cannot write the file: " + fileName);
+    fprintf(pFile, "%lu\nAssembly\n", (unsigned long)atoms.GetSize());
+    const CPointArray &Points = atoms.GetPoints();
+    for (DWORD i = 0; i < atoms.GetSize(); i++)
+        fprintf(pFile, "%s %.6f %.6f %.6f\n", atoms.GetElement(i).c_str(), Points.x[i], Points.y[i], Points.z[i]);
+    BOOL failed = ferror(pFile) != 0;
+    if (fclose(pFile) != 0 || failed)
+        throw runtime_error("Cannot write the file: " + fileName);
+}
+
+void CNCadSimphony::GetAssemblyArrays(CAssemblyArrays &arrays, SpatialOrderType order, DWORD workers)
+{
+    ERR err = arrays.Load(*GetWrapperInterface(), order, workers);
+    if (err)
+        throw runtime_error(err);
+}
+
+ERR CNCadSimphony::MakeAssemblyUuids(const BYTE *Namespace, DWORD n, const id_t *ids, BYTE *uuids,
+    DWORD workers)
+{
+    try
+    {
+        return MakeAtomUuids(*GetWrapperInterface(), Namespace, n, ids, uuids, workers);
+    }
+    catch (exception &)
+    {
+        return pERRAtomUuids;
+    }
+}
+
+void CNCadSimphony::ProcessAssemblyBonds(CNCadParticleContainer * pAssembly, const CAssemblyBondArrays &bonds,
+    const BYTE *bondUuids)
+{
+    for (DWORD i = 0; i < bonds.GetSize(); i++)
+    {
+        CNCadBond *pBond = new CNCadBond();
+        // The bonds of the assembly are numbered in the order of nCad, from 1
+        pBond->ID = i + 1;
+        pBond->atom1 = UuidToHex(UuidFromBytes(bonds.GetUuids1() + UUID_BYTES * i));
+        pBond->atom2 = UuidToHex(UuidFromBytes(bonds.GetUuids2() + UUID_BYTES * i));
+        ID_TYPE Simphony_ID = UuidToHex(UuidFromBytes(bondUuids + UUID_BYTES * i));
+        pAssembly->bonds[Simphony_ID] = pBond;
+        ProcessAssemblyBond(pBond, Simphony_ID);
+    }
+}
@@ -0,0 +1,89 @@
+#include "AssemblyBonds.h"
+#include "TaskPool.h"
+
+/**Below this number of bonds per range the atoms are resolved serially.*/
+#define BOND_MIN_RANGE 16384
+
+static const char *pERRBondAtom = "A bond has an atom without Simphony ID";
+
+//==============================================================================
+class CBondIDCollector : public NC_BondAction
+/**Action to copy the IDs of the atoms of the iterated bonds.*/
+{
+    vector<id_t> &ids1;
+    vector<id_t> &ids2;
+public:
+    CBondIDCollector(vector<id_t> &aIDs1, vector<id_t> &aIDs2) : ids1(aIDs1), ids2(aIDs2) {}
+    ERR DoAction(const NC_Bond &Bond)
+    {
+        ids1.push_back(Bond.ID1);
+        ids2.push_back(Bond.ID2);
+        return NULL;
+    }
+};
+
+class CBondResolveTask : public CTask
+/**Task that looks up the UUIDs of the atoms of a range of bonds.*/
+{
+    const CIdIndex &Index;
+    const id_t *ids1;
+    const id_t *ids2;
+    BYTE *uuids1;
+    BYTE *uuids2;
+    DWORD begin;
+    DWORD end;
+public:
+    CBondResolveTask(const CIdIndex &aIndex, const id_t *aIDs1, const id_t *aIDs2, BYTE *aUuids1,
+        BYTE *aUuids2, DWORD aBegin, DWORD aEnd) : Index(aIndex), ids1(aIDs1), ids2(aIDs2),
+        uuids1(aUuids1), uuids2(aUuids2), begin(aBegin), end(aEnd) {}
+    ERR Run()
+    {
+        for (DWORD i = begin; i < end; i++)
+            if (!Index.GetUuidBytes(ids1[i], uuids1 + UUID_BYTES * i) ||
+                !Index.GetUuidBytes(ids2[i], uuids2 + UUID_BYTES * i))
+                return pERRBondAtom;
+        return NULL;
+    }
+    double GetCost() const { return end - begin; }
+};
+
+//==============================================================================
+ERR CAssemblyBondArrays::Load(const NC_Wrapper &Wrapper, const CIdIndex &AtomUuids, DWORD workers)
+{
+    Clear();
+    CBondIDCollector Collector(ids1, ids2);
+    ERR err = Wrapper.ForEachBond(Collector);
+    DWORD n = ids1.size();
+    if (err || !n)
+    {
+        Clear();
+        return err;
+    }
+    uuids1.resize(UUID_BYTES * n);
+    uuids2.resize(UUID_BYTES * n);
+
+    DWORD nRanges = MAX(MIN(n / BOND_MIN_RANGE, (workers ? workers : CTaskPool::GetDefaultWorkers()) * 4), (DWORD)1);
+    vector<CTask*> tasks;
+    for (DWORD r = 0; r < nRanges; r++)
+        tasks.push_back(new CBondResolveTask(AtomUuids, &ids1[0], &ids2[0], &uuids1[0], &uuids2[0],
+            (DWORD)((DWORD64)n * r / nRanges), (DWORD)((DWORD64)n * (r + 1) / nRanges)));
+    if (tasks.size() == 1)
+        err = tasks[0]->Run();
+    else
+    {
+        CTaskPool Pool(workers);
+        err = Pool.Run(tasks);
+    }
+    DestroyPtrVector(tasks);
+    if (err)
+        Clear();
+    return err;
+}
+
+void CAssemblyBondArrays::Clear()
+{
+    ids1.clear();
+    ids2.clear();
+    uuids1.clear();
+    uuids2.clear();
+}
@@ -0,0 +1,89 @@
+#include "AsyncJob.h"
+#include "NCadSimphonyWrapper.h"
+
+#include <stdexcept>
+
+static const char *pERRJobThread = "Cannot start the job thread";
+static const char *pERRJobStarted = "The job was already started";
+static const char *pERRJobUnknown = "Unknown error of the job";
+
+//==============================================================================
+CAsyncJob::~CAsyncJob()
+{
+    if (thread)
+    {
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+    }
+}
+
+ERR CAsyncJob::Start()
+{
+    if (thread)
+        return pERRJobStarted;
+    thread = CreateThread(NULL, 0, JobProc, this, 0, NULL);
+    return thread ? NULL : pERRJobThread;
+}
+
+BOOL CAsyncJob::IsDone() const
+{
+    return Wait(0);
+}
+
+BOOL CAsyncJob::Wait(DWORD milliseconds) const
+{
+    return thread && WaitForSingleObject(thread, milliseconds) == WAIT_OBJECT_0;
+}
+
+DWORD WINAPI CAsyncJob::JobProc(LPVOID pParam)
+{
+    CAsyncJob *pJob = (CAsyncJob *)pParam;
+    // The exceptions cannot cross the thread, they become the result
+    try
+    {
+        pJob->result = pJob->Run();
+    }
+    catch (exception &e)
+    {
+        pJob->error = e.what();
+        pJob->result = pJob->error.c_str();
+    }
+    catch (...)
+    {
+        pJob->result = pERRJobUnknown;
+    }
+    return 0;
+}
+
+//==============================================================================
+CAssemblyJob::~CAssemblyJob()
+{
+    // The thread uses the members, so it must end before they are destroyed
+    Wait();
+}
+
+ERR CAssemblyJob::Run()
+{
+    // The components are processed by the DLL, which is not re-entrant, so
+    // the workers are only used by the adapter side steps
+    ncad.ProcessAll();
+    if (bondMaxLength > 0)
+        ncad.AutobondAssembly(bondMaxLength, workers);
+    if (pAssembly)
+    {
+        ncad.BeginAssembly();
+        ncad.GetAssemblyAtoms(pAssembly);
+    }
+    return NULL;
+}
+
+//==============================================================================
+CAssemblyBondsJob::~CAssemblyBondsJob()
+{
+    Wait();
+}
+
+ERR CAssemblyBondsJob::Run()
+{
+    return bonds.Load(*CNCadSimphony::GetWrapperInterface(), AtomUuids, workers);
+}
@@ -0,0 +1,179 @@
+#include "AtomGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+void CAtomGrid::Build()
+{
+    const CPointArray &Points = store.GetPoints();
+    DWORD n = Points.GetSize();
+    built = TRUE;
+    binStart.assign(2, 0);
+    order.clear();
+    binned.Clear();
+    dims[0] = dims[1] = dims[2] = 1;
+    binSize = 1;
+    if (n == 0)
+        return;
+
+    double min[3] = {MAX_DOUBLE, MAX_DOUBLE, MAX_DOUBLE};
+    double max[3] = {-MAX_DOUBLE, -MAX_DOUBLE, -MAX_DOUBLE};
+    const vector<double> *coords[3] = {&Points.x, &Points.y, &Points.z};
+    for (DWORD c = 0; c < 3; c++)
+        for (DWORD i = 0; i < n; i++)
+        {
+            min[c] = MIN(min[c], (*coords[c])[i]);
+            max[c] = MAX(max[c], (*coords[c])[i]);
+        }
+
+    // Bins with a few atoms on average, the flat directions of slabs and wires taken as
+    // one bin thick
+    double extent = MAX(MAX(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+    double volume = 1;
+    DWORD nDims = 0;
+    for (DWORD c = 0; c < 3; c++)
+        if (max[c] - min[c] > extent * 1e-6)
+        {
+            volume *= max[c] - min[c];
+            nDims++;
+        }
+    binSize = nDims ? pow(volume * ATOM_GRID_DENSITY / n, 1.0 / nDims) : 1;
+    if (!(binSize > 0))
+        binSize = 1;
+    // Degenerate boxes (e.g. a few atoms far apart) would make many more bins than atoms
+    double nBins;
+    for (;;)
+    {
+        nBins = 1;
+        for (DWORD c = 0; c < 3; c++)
+            nBins *= floor((max[c] - min[c]) / binSize) + 1;
+        if (nBins <= 2.0 * n + 8)
+            break;
+        binSize *= 2;
+    }
+    for (DWORD c = 0; c < 3; c++)
+        dims[c] = (long)((max[c] - min[c]) / binSize) + 1;
+    gridMin = Vector3D(min[0], min[1], min[2]);
+
+    // Counting sort of the atoms by bin, which keeps them in store order in each bin
+    vector<DWORD> bins(n);
+    binStart.assign((DWORD)nBins + 1, 0);
+    for (DWORD i = 0; i < n; i++)
+    {
+        long index[3];
+        for (DWORD c = 0; c < 3; c++)
+            index[c] = MIN((long)(((*coords[c])[i] - min[c]) / binSize), dims[c] - 1);
+        bins[i] = (index[2] * dims[1] + index[1]) * dims[0] + index[0];
+        binStart[bins[i] + 1]++;
+    }
+    for (DWORD b = 0; b + 1 < binStart.size(); b++)
+        binStart[b + 1] += binStart[b];
+    order.resize(n);
+    binned.Resize(n);
+    vector<DWORD> next(binStart.begin(), binStart.end() - 1);
+    for (DWORD i = 0; i < n; i++)
+    {
+        DWORD slot = next[bins[i]]++;
+        order[slot] = i;
+        binned.x[slot] = Points.x[i];
+        binned.y[slot] = Points.y[i];
+        binned.z[slot] = Points.z[i];
+    }
+}
+
+void CAtomGrid::BuildIfNeeded() const
+{
+    if (!built)
+        const_cast<CAtomGrid *>(this)->Build();
+}
+
+BOOL CAtomGrid::GetBinRange(const Vector3D &Min, const Vector3D &Max, long from[3], long to[3]) const
+{
+    if (order.empty())
+        return FALSE;
+    double min[3] = {Min.x - gridMin.x, Min.y - gridMin.y, Min.z - gridMin.z};
+    double max[3] = {Max.x - gridMin.x, Max.y - gridMin.y, Max.z - gridMin.z};
+    for (DWORD c = 0; c < 3; c++)
+    {
+        if (max[c] < 0 || min[c] > dims[c] * binSize || min[c] > max[c])
+            return FALSE;
+        from[c] = (long)MAX(floor(min[c] / binSize), 0.0);
+        // The atoms on the upper limit of the grid are in the last bin
+        to[c] = (long)MIN(floor(max[c] / binSize), (double)(dims[c] - 1));
+    }
+    return TRUE;
+}
+
+//==============================================================================
+void CAtomGrid::FindInBox(const Vector3DBox &Box, vector<DWORD> &indexes) const
+{
+    BuildIfNeeded();
+    if (Box.IsEmpty())
+        return;
+    Vector3D Min = Box.GetBoxCornerMin();
+    Vector3D Max = Box.GetBoxCornerMax();
+    long from[3], to[3];
+    if (!GetBinRange(Min, Max, from, to))
+        return;
+    DWORD first = indexes.size();
+    for (long k = from[2]; k <= to[2]; k++)
+        for (long j = from[1]; j <= to[1]; j++)
+            for (long i = from[0]; i <= to[0]; i++)
+            {
+                DWORD bin = (k * dims[1] + j) * dims[0] + i;
+                DWORD begin = binStart[bin];
+                DWORD end = binStart[bin + 1];
+                // The bins strictly inside the range of bins are inside the box
+                BOOL inner = i > from[0] && i < to[0] && j > from[1] && j < to[1] && k > from[2] && k < to[2];
+                for (DWORD a = begin; a < end; a++)
+                    if (inner ||
+                        (binned.x[a] >= Min.x && binned.x[a] <= Max.x &&
+                         binned.y[a] >= Min.y && binned.y[a] <= Max.y &&
+                         binned.z[a] >= Min.z && binned.z[a] <= Max.z))
+                        indexes.push_back(order[a]);
+            }
+    sort(indexes.begin() + first, indexes.end());
+}
+
+void CAtomGrid::FindInRadius(const Vector3D &Center, double radius, vector<DWORD> &indexes) const
+{
+    BuildIfNeeded();
+    if (radius < 0)
+        return;
+    Vector3D Radius(radius, radius, radius);
+    long from[3], to[3];
+    if (!GetBinRange(Center - Radius, Center + Radius, from, to))
+        return;
+    DWORD first = indexes.size();
+    double radius2 = radius * radius;
+    for (long k = from[2]; k <= to[2]; k++)
+        for (long j = from[1]; j <= to[1]; j++)
+            for (long i = from[0]; i <= to[0]; i++)
+            {
+                DWORD bin = (k * dims[1] + j) * dims[0] + i;
+                DWORD begin = binStart[bin];
+                DWORD end = binStart[bin + 1];
+                if (begin == end)
+                    continue;
+                // The bin is inside the sphere if its farthest corner is
+                double far2 = 0;
+                long index[3] = {i, j, k};
+                double center[3] = {Center.x - gridMin.x, Center.y - gridMin.y, Center.z - gridMin.z};
+                for (DWORD c = 0; c < 3; c++)
+                {
+                    double d = MAX(fabs(index[c] * binSize - center[c]), fabs((index[c] + 1) * binSize - center[c]));
+                    far2 += d * d;
+                }
+                BOOL inner = far2 <= radius2 && i < dims[0] - 1 && j < dims[1] - 1 && k < dims[2] - 1;
+                for (DWORD a = begin; a < end; a++)
+                {
+                    double dx = binned.x[a] - Center.x;
+                    double dy = binned.y[a] - Center.y;
+                    double dz = binned.z[a] - Center.z;
+                    if (inner || dx * dx + dy * dy + dz * dz <= radius2)
+                        indexes.push_back(order[a]);
+                }
+            }
+    sort(indexes.begin() + first, indexes.end());
+}
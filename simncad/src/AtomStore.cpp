@@ -0,0 +1,67 @@
+#include "AtomStore.h"
+
+//==============================================================================
+void CAtomStore::Reserve(DWORD n)
+{
+    ids.reserve(n);
+    xyz.x.reserve(n);
+    xyz.y.reserve(n);
+    xyz.z.reserve(n);
+    elements.reserve(n);
+    labels.reserve(n);
+    occupancies.reserve(n);
+}
+
+void CAtomStore::Clear()
+{
+    ClearAtoms();
+    speciesNames.Clear();
+    speciesElements.clear();
+    labelNames.Clear();
+}
+
+void CAtomStore::ClearAtoms()
+{
+    ids.clear();
+    xyz.Clear();
+    elements.clear();
+    labels.clear();
+    occupancies.clear();
+}
+
+/**Puts the item order[i] of a vector at the position i.*/
+template <class T>
+static void Permute(vector<T> &items, const vector<DWORD> &order)
+{
+    vector<T> permuted(order.size());
+    for (DWORD i = 0; i < order.size(); i++)
+        permuted[i] = items[order[i]];
+    items.swap(permuted);
+}
+
+void CAtomStore::Reorder(const vector<DWORD> &order)
+{
+    Permute(ids, order);
+    Permute(xyz.x, order);
+    Permute(xyz.y, order);
+    Permute(xyz.z, order);
+    Permute(elements, order);
+    Permute(labels, order);
+    Permute(occupancies, order);
+}
+
+WORD CAtomStore::InternElement(const string &element)
+{
+    ElementNumber number = ::GetElementNumber(element);
+    if (number != elementNone && GetElementSymbol(number) == element)
+        return number;
+    DWORD index = speciesNames.Intern(element);
+    if (index == speciesElements.size())
+        speciesElements.push_back(number);
+    return elementMAX + index;
+}
+
+void CAtomStore::Add(const NC_Atom &Atom)
+{
+    Add(Atom.GetID(), Atom.xyz, InternElement(Atom.Element), InternLabel(Atom.Label), Atom.Occupancy);
+}
@@ -0,0 +1,135 @@
+#include "AtomUuids.h"
+#include "TaskPool.h"
+#include "Service.h"
+
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+
+static const char *pERRBondUuids = "Cannot make the UUIDs of the bonds";
+
+/**Below this number of atoms or bonds per range the UUIDs are made serially.*/
+#define UUID_MIN_RANGE 4096
+
+//==============================================================================
+class CAtomUuidTask : public CTask
+/**Task that makes the UUIDs of a range of atoms.*/
+{
+    const CUuid &Namespace;
+    const int *components;
+    const id_t *ids;
+    BYTE *uuids;
+    DWORD begin;
+    DWORD end;
+public:
+    CAtomUuidTask(const CUuid &aNamespace, const int *aComponents, const id_t *aIDs, BYTE *aUuids,
+        DWORD aBegin, DWORD aEnd) : Namespace(aNamespace), components(aComponents), ids(aIDs),
+        uuids(aUuids), begin(aBegin), end(aEnd) {}
+    ERR Run()
+    {
+        BYTE name[ATOM_NAME_BYTES];
+        for (DWORD i = begin; i < end; i++)
+        {
+            for (DWORD j = 0; j < 4; j++)
+                name[j] = (BYTE)((DWORD)components[i] >> (24 - 8 * j));
+            for (DWORD j = 0; j < 8; j++)
+                name[4 + j] = (BYTE)(ids[i] >> (56 - 8 * j));
+            UuidToBytes(UuidFromName(Namespace, name, ATOM_NAME_BYTES), uuids + UUID_BYTES * i);
+        }
+        return NULL;
+    }
+    double GetCost() const { return end - begin; }
+};
+
+class CBondUuidTask : public CTask
+/**Task that makes the UUIDs of a range of bonds.*/
+{
+    const CUuid &Namespace;
+    const BYTE *uuids1;
+    const BYTE *uuids2;
+    BYTE *uuids;
+    DWORD begin;
+    DWORD end;
+public:
+    CBondUuidTask(const CUuid &aNamespace, const BYTE *aUuids1, const BYTE *aUuids2, BYTE *aUuids,
+        DWORD aBegin, DWORD aEnd) : Namespace(aNamespace), uuids1(aUuids1), uuids2(aUuids2),
+        uuids(aUuids), begin(aBegin), end(aEnd) {}
+    ERR Run()
+    {
+        BYTE name[BOND_NAME_BYTES];
+        for (DWORD i = begin; i < end; i++)
+        {
+            const BYTE *uuid1 = uuids1 + UUID_BYTES * i;
+            const BYTE *uuid2 = uuids2 + UUID_BYTES * i;
+            if (memcmp(uuid1, uuid2, UUID_BYTES) > 0)
+                swap(uuid1, uuid2);
+            memcpy(name, uuid1, UUID_BYTES);
+            memcpy(name + UUID_BYTES, uuid2, UUID_BYTES);
+            UuidToBytes(UuidFromName(Namespace, name, BOND_NAME_BYTES), uuids + UUID_BYTES * i);
+        }
+        return NULL;
+    }
+    double GetCost() const { return end - begin; }
+};
+
+//==============================================================================
+/**Returns the number of ranges of n UUIDs to make.*/
+static DWORD GetNUuidRanges(DWORD n, DWORD workers)
+{
+    return MAX(MIN(n / UUID_MIN_RANGE, (workers ? workers : CTaskPool::GetDefaultWorkers()) * 4), (DWORD)1);
+}
+
+/**Runs the tasks that make the UUIDs, serially if there is only one, and destroys them.*/
+static ERR RunUuidTasks(vector<CTask*> &tasks, DWORD workers)
+{
+    ERR err;
+    if (tasks.size() == 1)
+        err = tasks[0]->Run();
+    else
+    {
+        CTaskPool Pool(workers);
+        err = Pool.Run(tasks);
+    }
+    DestroyPtrVector(tasks);
+    return err;
+}
+
+ERR MakeAtomUuids(const NC_Wrapper &Wrapper, const BYTE *Namespace, DWORD n, const id_t *ids,
+    BYTE *uuids, DWORD workers)
+{
+    if (!n)
+        return NULL;
+    // The wrapper is only asked from this thread
+    vector<int> components(n);
+    for (DWORD i = 0; i < n; i++)
+        components[i] = Wrapper.GetComponentIDByAtomID(ids[i]);
+    CUuid Space = UuidFromBytes(Namespace);
+
+    DWORD nRanges = GetNUuidRanges(n, workers);
+    vector<CTask*> tasks;
+    for (DWORD r = 0; r < nRanges; r++)
+        tasks.push_back(new CAtomUuidTask(Space, &components[0], ids, uuids,
+            (DWORD)((DWORD64)n * r / nRanges), (DWORD)((DWORD64)n * (r + 1) / nRanges)));
+    return RunUuidTasks(tasks, workers);
+}
+
+ERR MakeBondUuids(const BYTE *Namespace, DWORD n, const BYTE *uuids1, const BYTE *uuids2, BYTE *uuids,
+    DWORD workers)
+{
+    if (!n)
+        return NULL;
+    CUuid Space = UuidFromBytes(Namespace);
+    try
+    {
+        DWORD nRanges = GetNUuidRanges(n, workers);
+        vector<CTask*> tasks;
+        for (DWORD r = 0; r < nRanges; r++)
+            tasks.push_back(new CBondUuidTask(Space, uuids1, uuids2, uuids,
+                (DWORD)((DWORD64)n * r / nRanges), (DWORD)((DWORD64)n * (r + 1) / nRanges)));
+        return RunUuidTasks(tasks, workers);
+    }
+    catch (exception &)
+    {
+        return pERRBondUuids;
+    }
+}
@@ -0,0 +1,138 @@
+#include "NCadSimphonyWrapper.h"
+#include "NeighbourSearch.h"
+
+#include <stdexcept>
+#include <set>
+
+static const char *pERRCellBond = "Cannot add a bond to the cell: ";
+
+/**Position IDs of the atoms of a cell bond, the smallest first.*/
+typedef pair<DWORD, DWORD> CPositionPair;
+
+static CPositionPair GetPositionPair(id_t ID1, id_t ID2)
+{
+    DWORD Position1 = CellAtomID(ID1).Indexes.Position;
+    DWORD Position2 = CellAtomID(ID2).Indexes.Position;
+    return Position1 < Position2 ? CPositionPair(Position1, Position2)
+                                 : CPositionPair(Position2, Position1);
+}
+
+class CCellBondCollector : public NC_BondAction
+/**Collects the pairs of positions already bonded in a cell, one per bond batch.*/
+{
+    set<CPositionPair> &bonded;
+public:
+    CCellBondCollector(set<CPositionPair> &aBonded) : bonded(aBonded) {}
+    ERR DoAction(const NC_Bond &Bond)
+    {
+        bonded.insert(GetPositionPair(Bond.ID1, Bond.ID2));
+        return NULL;
+    }
+};
+
+/**IDs of the atoms of an assembly bond, the smallest first.*/
+typedef pair<id_t, id_t> CAtomPair;
+
+static CAtomPair GetAtomPair(id_t ID1, id_t ID2)
+{
+    return ID1 < ID2 ? CAtomPair(ID1, ID2) : CAtomPair(ID2, ID1);
+}
+
+class CAssemblyBondCollector : public NC_BondAction
+/**Collects the pairs of atoms already bonded in the assembly.*/
+{
+    set<CAtomPair> &bonded;
+public:
+    CAssemblyBondCollector(set<CAtomPair> &aBonded) : bonded(aBonded) {}
+    ERR DoAction(const NC_Bond &Bond)
+    {
+        bonded.insert(GetAtomPair(Bond.ID1, Bond.ID2));
+        return NULL;
+    }
+};
+
+void CNCadSimphony::AutobondCell(string &name, double distance, DWORD workers)
+{
+    CNCadCell *pNCadCell = dynamic_cast<CNCadCell *>(getCell(name.c_str()));
+    if (!pNCadCell || !pNCadCell->pCell)
+        throw runtime_error("Cell not found: " + name);
+    NC_Cell *pCell = pNCadCell->pCell;
+
+    CAtomStore atoms;
+    CAtomStoreCollector Collector(atoms);
+    ERR err = pCell->ForEachAtom(Collector);
+    if (err)
+        throw runtime_error(err);
+    const vector<id_t> &ids = atoms.GetIDs();
+    vector<Vector3D> xyz(atoms.GetSize());
+    for (DWORD i = 0; i < xyz.size(); i++)
+        xyz[i] = atoms.GetXYZ(i);
+
+    // Cell bonds link two atomic positions and have no cell shift, so only
+    // the pairs inside the cell are searched, without the periodic images
+    CNeighbourSearch search;
+    vector<CNeighbourPair> pairs;
+    err = search.Init(xyz, distance);
+    if (!err)
+        err = search.FindPairs(workers, pairs);
+    if (err)
+        throw runtime_error(err);
+
+    set<CPositionPair> bonded;
+    CCellBondCollector BondCollector(bonded);
+    err = pCell->ForEachBondBatch(BondCollector);
+    if (err)
+        throw runtime_error(err);
+
+    // Each pair of positions is bonded once, and the atoms of the same position (of a site
+    // of mixed occupancy) are not bonded to each other
+    for (DWORD p = 0; p < pairs.size(); p++)
+    {
+        id_t ID1 = ids[pairs[p].atom1];
+        id_t ID2 = ids[pairs[p].atom2];
+        CPositionPair Positions = GetPositionPair(ID1, ID2);
+        if (Positions.first == Positions.second || !bonded.insert(Positions).second)
+            continue;
+        if (pCell->AddBond(NC_Bond::CreateBondForCell(ID1, ID2)) < 0)
+            throw runtime_error(pERRCellBond + name);
+    }
+}
+
+void CNCadSimphony::AutobondAssembly(double distance, DWORD workers)
+{
+    NC_Wrapper *pWrapper = GetWrapperInterface();
+    CAtomStore atoms;
+    CAtomStoreCollector Collector(atoms);
+    ERR err = pWrapper->ForEachAtom(Collector);
+    const vector<id_t> &ids = atoms.GetIDs();
+    vector<Vector3D> xyz(atoms.GetSize());
+    for (DWORD i = 0; i < xyz.size(); i++)
+        xyz[i] = atoms.GetXYZ(i);
+
+    CNeighbourSearch search;
+    vector<CNeighbourPair> pairs;
+    if (!err)
+        err = search.Init(xyz, distance);
+    if (!err)
+        err = search.FindPairs(workers, pairs);
+    if (err)
+        throw runtime_error(err);
+
+    // The pairs already bonded (e.g. by the bonds of the cells) are bonded once
+    set<CAtomPair> bonded;
+    CAssemblyBondCollector BondCollector(bonded);
+    err = pWrapper->ForEachBond(BondCollector);
+    if (err)
+        throw runtime_error(err);
+
+    for (DWORD p = 0; p < pairs.size(); p++)
+    {
+        id_t ID1 = ids[pairs[p].atom1];
+        id_t ID2 = ids[pairs[p].atom2];
+        if (!bonded.insert(GetAtomPair(ID1, ID2)).second)
+            continue;
+        err = pWrapper->SetBond(NC_Bond::CreateBondForComponent(ID1, ID2));
+        if (err)
+            throw runtime_error(err);
+    }
+}
@@ -0,0 +1,26 @@
+#include "BatchActions.h"
+
+//==============================================================================
+void GetAtomSpan(const CAtomStore &store, DWORD first, DWORD count, NC_AtomSpan &Atoms)
+{
+    Atoms.pStore = &store;
+    Atoms.first = first;
+    Atoms.count = count;
+    if (count == 0)
+    {
+        // The arrays may be empty, there is nothing to point to
+        Atoms.ids = NULL;
+        Atoms.x = Atoms.y = Atoms.z = Atoms.occupancies = NULL;
+        Atoms.elements = NULL;
+        Atoms.labels = NULL;
+        return;
+    }
+    const CPointArray &Points = store.GetPoints();
+    Atoms.ids = &store.GetIDs()[first];
+    Atoms.x = &Points.x[first];
+    Atoms.y = &Points.y[first];
+    Atoms.z = &Points.z[first];
+    Atoms.elements = &store.GetElementCodes()[first];
+    Atoms.labels = &store.GetLabelIndexes()[first];
+    Atoms.occupancies = &store.GetOccupancies()[first];
+}
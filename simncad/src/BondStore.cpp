@@ -0,0 +1,194 @@
+#include "BondStore.h"
+
+#include <algorithm>
+
+static const char *pERRBondAtom = "Bond with an atom that is not in the store";
+static const char *pERRBondParams = "Too many different bond parameters";
+
+//==============================================================================
+/**Bond between two atom indexes, in one of its directions.*/
+typedef struct {
+    DWORD atom;
+    DWORD neighbour;
+    WORD params;
+} CDirectedBond;
+
+/**Orders the bonds by atom and neighbour, keeping the order of addition of the equal ones.*/
+static bool IsDirectedBondLess(const CDirectedBond &a, const CDirectedBond &b)
+{
+    return a.atom < b.atom || (a.atom == b.atom && a.neighbour < b.neighbour);
+}
+
+//==============================================================================
+DWORD CBondStore::InternParameters(vector<BondParameters> &table, const BondParameters &Params)
+{
+    DWORD p = 0;
+    while (p < table.size() && !(table[p] == Params))
+        p++;
+    if (p == table.size())
+        table.push_back(Params);
+    return p;
+}
+
+void CBondStore::Add(id_t id1, id_t id2, const BondParameters &Params)
+{
+    DWORD p = InternParameters(parameters, Params);
+    CPendingBond Bond;
+    Bond.id1 = id1;
+    Bond.id2 = id2;
+    Bond.params = p > (WORD)-1 ? (WORD)-1 : (WORD)p;
+    pending.push_back(Bond);
+}
+
+void CBondStore::Clear()
+{
+    pending.clear();
+    parameters.clear();
+    rowStart.clear();
+    neighbours.clear();
+    neighbourParams.clear();
+    nBonds = 0;
+    sortedIDs.clear();
+    sortedIndexes.clear();
+    atomIDs.clear();
+}
+
+ERR CBondStore::Build(const CAtomStore &atoms)
+{
+    if (parameters.size() > (WORD)-1)
+        return pERRBondParams;
+
+    // The bonds of a previous Build are kept, by the IDs of their atoms
+    vector<CPendingBond> bonds;
+    bonds.reserve(nBonds + pending.size());
+    for (DWORD i = 0; i + 1 < rowStart.size(); i++)
+        for (DWORD e = rowStart[i]; e < rowStart[i + 1]; e++)
+            if (neighbours[e] >= i)
+            {
+                CPendingBond Bond;
+                Bond.id1 = atomIDs[i];
+                Bond.id2 = atomIDs[neighbours[e]];
+                Bond.params = neighbourParams[e];
+                bonds.push_back(Bond);
+            }
+    bonds.insert(bonds.end(), pending.begin(), pending.end());
+
+    // Index of the IDs of the atoms
+    const vector<id_t> &ids = atoms.GetIDs();
+    DWORD nAtoms = ids.size();
+    vector<pair<id_t, DWORD> > index(nAtoms);
+    for (DWORD i = 0; i < nAtoms; i++)
+        index[i] = make_pair(ids[i], i);
+    sort(index.begin(), index.end());
+    vector<id_t> newSortedIDs(nAtoms);
+    vector<DWORD> newSortedIndexes(nAtoms);
+    for (DWORD i = 0; i < nAtoms; i++)
+    {
+        newSortedIDs[i] = index[i].first;
+        newSortedIndexes[i] = index[i].second;
+    }
+    sortedIDs.swap(newSortedIDs);
+    sortedIndexes.swap(newSortedIndexes);
+
+    // Both directions of every bond, by atom indexes
+    vector<CDirectedBond> directed;
+    directed.reserve(2 * bonds.size());
+    for (DWORD b = 0; b < bonds.size(); b++)
+    {
+        CDirectedBond Bond;
+        Bond.atom = GetAtomIndex(bonds[b].id1);
+        Bond.neighbour = GetAtomIndex(bonds[b].id2);
+        Bond.params = bonds[b].params;
+        if (Bond.atom == ATOM_NONE || Bond.neighbour == ATOM_NONE)
+        {
+            // The store is left as it was
+            sortedIDs.swap(newSortedIDs);
+            sortedIndexes.swap(newSortedIndexes);
+            return pERRBondAtom;
+        }
+        directed.push_back(Bond);
+        if (Bond.atom != Bond.neighbour)
+        {
+            swap(Bond.atom, Bond.neighbour);
+            directed.push_back(Bond);
+        }
+    }
+    stable_sort(directed.begin(), directed.end(), IsDirectedBondLess);
+
+    // Rows of the adjacency lists, the last of the repeated bonds wins
+    rowStart.assign(nAtoms + 1, 0);
+    neighbours.clear();
+    neighbourParams.clear();
+    neighbours.reserve(directed.size());
+    neighbourParams.reserve(directed.size());
+    nBonds = 0;
+    for (DWORD e = 0; e < directed.size(); e++)
+    {
+        const CDirectedBond &Bond = directed[e];
+        if (e + 1 < directed.size() && directed[e + 1].atom == Bond.atom && directed[e + 1].neighbour == Bond.neighbour)
+            continue;
+        neighbours.push_back(Bond.neighbour);
+        neighbourParams.push_back(Bond.params);
+        rowStart[Bond.atom + 1]++;
+        if (Bond.neighbour >= Bond.atom)
+            nBonds++;
+    }
+    for (DWORD i = 0; i < nAtoms; i++)
+        rowStart[i + 1] += rowStart[i];
+
+    atomIDs = ids;
+    pending.clear();
+    return NULL;
+}
+
+void CBondStore::Reorder(const vector<DWORD> &order)
+{
+    DWORD nAtoms = GetNAtoms();
+    vector<DWORD> newIndex(nAtoms);
+    for (DWORD i = 0; i < nAtoms; i++)
+        newIndex[order[i]] = i;
+
+    // The rows are copied in the new order, with the neighbours renumbered and sorted again
+    vector<DWORD> newRowStart(nAtoms + 1, 0);
+    vector<DWORD> newNeighbours(neighbours.size());
+    vector<WORD> newNeighbourParams(neighbourParams.size());
+    for (DWORD i = 0; i < nAtoms; i++)
+    {
+        DWORD old = order[i];
+        DWORD e = newRowStart[i];
+        for (DWORD o = rowStart[old]; o < rowStart[old + 1]; o++, e++)
+        {
+            // Insertion sort, the rows are short
+            DWORD neighbour = newIndex[neighbours[o]];
+            WORD params = neighbourParams[o];
+            DWORD k = e;
+            for (; k > newRowStart[i] && newNeighbours[k - 1] > neighbour; k--)
+            {
+                newNeighbours[k] = newNeighbours[k - 1];
+                newNeighbourParams[k] = newNeighbourParams[k - 1];
+            }
+            newNeighbours[k] = neighbour;
+            newNeighbourParams[k] = params;
+        }
+        newRowStart[i + 1] = e;
+    }
+    rowStart.swap(newRowStart);
+    neighbours.swap(newNeighbours);
+    neighbourParams.swap(newNeighbourParams);
+
+    vector<id_t> newAtomIDs(nAtoms);
+    for (DWORD i = 0; i < nAtoms; i++)
+        newAtomIDs[i] = atomIDs[order[i]];
+    atomIDs.swap(newAtomIDs);
+    for (DWORD i = 0; i < sortedIndexes.size(); i++)
+        sortedIndexes[i] = newIndex[sortedIndexes[i]];
+}
+
+//==============================================================================
+DWORD CBondStore::GetAtomIndex(id_t id) const
+{
+    vector<id_t>::const_iterator it = lower_bound(sortedIDs.begin(), sortedIDs.end(), id);
+    if (it == sortedIDs.end() || *it != id)
+        return ATOM_NONE;
+    return sortedIndexes[it - sortedIDs.begin()];
+}
@@ -0,0 +1,260 @@
+#include "Cursors.h"
+
+static const char *pERRCursorThread = "Cannot start the cursor thread";
+static const char *pERRCursorClosed = "The cursor was closed";
+static const char *pERRCursorParams = "Too many different bond parameters";
+
+//==============================================================================
+CCursorQueue::CCursorQueue(DWORD aDepth) : depth(MAX(aDepth, (DWORD)1)), thread(NULL), freeSlots(NULL),
+    filledSlots(NULL), closed(0), pSource(NULL), writeSlot(0), readSlot(0), holding(FALSE),
+    finished(FALSE), result(NULL)
+{
+}
+
+CCursorQueue::~CCursorQueue()
+{
+    Close();
+}
+
+ERR CCursorQueue::Start(CCursorSource *aSource)
+{
+    pSource = aSource;
+    closed = 0;
+    writeSlot = readSlot = 0;
+    holding = finished = FALSE;
+    result = NULL;
+    endSlots.assign(GetSlots(), FALSE);
+    freeSlots = CreateSemaphore(NULL, GetSlots(), 0x7FFFFFFF, NULL);
+    filledSlots = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+    if (freeSlots && filledSlots)
+        thread = CreateThread(NULL, 0, ProducerProc, this, 0, NULL);
+    if (!thread)
+    {
+        Close();
+        return pERRCursorThread;
+    }
+    return NULL;
+}
+
+void CCursorQueue::Close()
+{
+    if (thread)
+    {
+        // The producer only waits for free slots, so it wakes up and sees the cursor closed
+        InterlockedExchange(&closed, 1);
+        ReleaseSemaphore(freeSlots, GetSlots(), NULL);
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+        thread = NULL;
+    }
+    if (freeSlots)
+        CloseHandle(freeSlots);
+    if (filledSlots)
+        CloseHandle(filledSlots);
+    freeSlots = filledSlots = NULL;
+    delete pSource;
+    pSource = NULL;
+    finished = TRUE;
+    result = NULL;
+}
+
+DWORD WINAPI CCursorQueue::ProducerProc(LPVOID pParam)
+{
+    CCursorQueue *pQueue = (CCursorQueue *)pParam;
+    // The result is written before the end slot is published, which orders the memory
+    pQueue->result = pQueue->Produce(*pQueue->pSource);
+    DWORD slot;
+    if (pQueue->AcquireSlot(slot))
+    {
+        pQueue->endSlots[slot] = TRUE;
+        pQueue->PublishSlot();
+    }
+    return 0;
+}
+
+BOOL CCursorQueue::AcquireSlot(DWORD &slot)
+{
+    WaitForSingleObject(freeSlots, INFINITE);
+    if (closed)
+        return FALSE;
+    slot = writeSlot;
+    endSlots[slot] = FALSE;
+    return TRUE;
+}
+
+void CCursorQueue::PublishSlot()
+{
+    writeSlot = (writeSlot + 1) % GetSlots();
+    ReleaseSemaphore(filledSlots, 1, NULL);
+}
+
+BOOL CCursorQueue::TakeSlot(DWORD &slot, ERR &err)
+{
+    err = NULL;
+    if (finished || !thread)
+    {
+        err = result;
+        return FALSE;
+    }
+    if (holding)
+    {
+        ReleaseSemaphore(freeSlots, 1, NULL);
+        holding = FALSE;
+    }
+    WaitForSingleObject(filledSlots, INFINITE);
+    slot = readSlot;
+    readSlot = (readSlot + 1) % GetSlots();
+    if (endSlots[slot])
+    {
+        finished = TRUE;
+        err = result;
+        return FALSE;
+    }
+    holding = TRUE;
+    return TRUE;
+}
+
+//==============================================================================
+CAtomCursor::CAtomCursor(DWORD aBatchSize, DWORD aDepth) : CCursorQueue(aDepth),
+    batchSize(aBatchSize ? aBatchSize : BATCH_SIZE), producerSlot(0), filling(FALSE), pStore(NULL), position(0)
+{
+    blocks.resize(GetSlots());
+    GetAtomSpan(blocks[0], 0, 0, atoms);
+}
+
+ERR CAtomCursor::Open(const CAtomStore &store)
+{
+    Close();
+    pStore = &store;
+    return NULL;
+}
+
+void CAtomCursor::Close()
+{
+    CCursorQueue::Close();
+    pStore = NULL;
+    position = 0;
+    filling = FALSE;
+    GetAtomSpan(blocks[0], 0, 0, atoms);
+}
+
+ERR CAtomCursor::Next()
+{
+    if (pStore)
+    {
+        position = MIN(position + atoms.count, pStore->GetSize());
+        GetAtomSpan(*pStore, position, MIN(batchSize, pStore->GetSize() - position), atoms);
+        return NULL;
+    }
+    DWORD slot;
+    ERR err;
+    if (TakeSlot(slot, err))
+        GetAtomSpan(blocks[slot], 0, blocks[slot].GetSize(), atoms);
+    else
+        GetAtomSpan(blocks[0], 0, 0, atoms);
+    return err;
+}
+
+ERR CAtomCursor::Produce(const CCursorSource &Source)
+{
+    ERR err = Source.ForEachAtom(*this);
+    Flush();
+    return err;
+}
+
+ERR CAtomCursor::DoAction(const NC_Atom &Atom)
+{
+    if (!filling)
+    {
+        if (!AcquireSlot(producerSlot))
+            return pERRCursorClosed;
+        blocks[producerSlot].ClearAtoms();
+        filling = TRUE;
+    }
+    blocks[producerSlot].Add(Atom);
+    if (blocks[producerSlot].GetSize() == batchSize)
+        Flush();
+    return NULL;
+}
+
+void CAtomCursor::Flush()
+{
+    if (filling)
+        PublishSlot();
+    filling = FALSE;
+}
+
+//==============================================================================
+CBondCursor::CBondCursor(DWORD aBatchSize, DWORD aDepth) : CCursorQueue(aDepth),
+    batchSize(aBatchSize ? aBatchSize : BATCH_SIZE), producerSlot(0), filling(FALSE)
+{
+    blocks.resize(GetSlots());
+    SetBonds(emptyBlock);
+}
+
+void CBondCursor::SetBonds(const CBondBlock &Block)
+{
+    bonds.count = Block.ids1.size();
+    bonds.ids1 = bonds.count ? &Block.ids1[0] : NULL;
+    bonds.ids2 = bonds.count ? &Block.ids2[0] : NULL;
+    bonds.params = bonds.count ? &Block.params[0] : NULL;
+    bonds.pParameters = Block.parameters.empty() ? NULL : &Block.parameters[0];
+}
+
+void CBondCursor::Close()
+{
+    CCursorQueue::Close();
+    filling = FALSE;
+    SetBonds(emptyBlock);
+}
+
+ERR CBondCursor::Next()
+{
+    DWORD slot;
+    ERR err;
+    if (TakeSlot(slot, err))
+        SetBonds(blocks[slot]);
+    else
+        SetBonds(emptyBlock);
+    return err;
+}
+
+ERR CBondCursor::Produce(const CCursorSource &Source)
+{
+    ERR err = Source.ForEachBond(*this);
+    Flush();
+    return err;
+}
+
+ERR CBondCursor::DoAction(const NC_Bond &Bond)
+{
+    if (!filling)
+    {
+        if (!AcquireSlot(producerSlot))
+            return pERRCursorClosed;
+        CBondBlock &Block = blocks[producerSlot];
+        Block.ids1.clear();
+        Block.ids2.clear();
+        Block.params.clear();
+        Block.parameters.clear();
+        filling = TRUE;
+    }
+    CBondBlock &Block = blocks[producerSlot];
+    Block.ids1.push_back(Bond.ID1);
+    Block.ids2.push_back(Bond.ID2);
+    // A block has at most batchSize different parameters, but they must fit a WORD
+    DWORD p = CBondStore::InternParameters(Block.parameters, Bond.BondParams);
+    if (p > (WORD)-1)
+        return pERRCursorParams;
+    Block.params.push_back((WORD)p);
+    if (Block.ids1.size() == batchSize)
+        Flush();
+    return NULL;
+}
+
+void CBondCursor::Flush()
+{
+    if (filling)
+        PublishSlot();
+    filling = FALSE;
+}
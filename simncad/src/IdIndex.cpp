@@ -0,0 +1,54 @@
+#include "IdIndex.h"
+
+//==============================================================================
+void CIdIndex::Clear()
+{
+    uuids.Clear();
+    ids.Clear();
+}
+
+void CIdIndex::Reserve(DWORD n)
+{
+    uuids.Reserve(n);
+    ids.Reserve(n);
+}
+
+void CIdIndex::Set(id_t id, const CUuid &Uuid)
+{
+    const CUuid *pOld = uuids.Find(id);
+    if (pOld && *pOld == Uuid)
+        return;
+    RemoveID(id);
+    RemoveUuid(Uuid);
+    uuids.Insert(id, Uuid);
+    ids.Insert(Uuid, id);
+}
+
+BOOL CIdIndex::RemoveID(id_t id)
+{
+    const CUuid *pUuid = uuids.Find(id);
+    if (!pUuid)
+        return FALSE;
+    ids.Remove(*pUuid);
+    uuids.Remove(id);
+    return TRUE;
+}
+
+BOOL CIdIndex::RemoveUuid(const CUuid &Uuid)
+{
+    const id_t *pID = ids.Find(Uuid);
+    if (!pID)
+        return FALSE;
+    uuids.Remove(*pID);
+    ids.Remove(Uuid);
+    return TRUE;
+}
+
+BOOL CIdIndex::GetUuidBytes(id_t id, BYTE *uuid) const
+{
+    const CUuid *pUuid = uuids.Find(id);
+    if (!pUuid)
+        return FALSE;
+    UuidToBytes(*pUuid, uuid);
+    return TRUE;
+}
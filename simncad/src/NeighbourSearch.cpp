@@ -0,0 +1,163 @@
+#include "NeighbourSearch.h"
+#include "TaskPool.h"
+
+#include <math.h>
+#include <algorithm>
+
+static const char *pERRNeighbourCutoff = "The neighbour search cutoff must be positive";
+
+// Upper bound of the number of bins per binned atom, larger grids are coarsened
+#define NEIGHBOUR_BINS_PER_ATOM 8
+
+/**Orders the pairs of a single first atom by second atom.*/
+static bool IsPairLess(const CNeighbourPair &p1, const CNeighbourPair &p2)
+{
+    return p1.atom2 < p2.atom2;
+}
+
+class CPairSearchTask : public CTask
+/**Task that finds the pairs of a range of first atoms.*/
+{
+    const CNeighbourSearch &search;
+    DWORD first;
+    DWORD last;
+public:
+    /**Pairs found by the task.*/
+    vector<CNeighbourPair> pairs;
+    CPairSearchTask(const CNeighbourSearch &aSearch, DWORD aFirst, DWORD aLast) :
+        search(aSearch), first(aFirst), last(aLast) {}
+    ERR Run() { return search.FindPairs(first, last, pairs); }
+    double GetCost() const { return last - first; }
+};
+
+//==============================================================================
+CNeighbourSearch::CNeighbourSearch() : cutoff(0), nAtoms(0), binSize(0)
+{
+    dims[0] = dims[1] = dims[2] = 0;
+}
+
+ERR CNeighbourSearch::Init(const vector<Vector3D> &xyz, double aCutoff)
+{
+    if (aCutoff <= 0)
+        return pERRNeighbourCutoff;
+    cutoff = aCutoff;
+    nAtoms = xyz.size();
+    atomXYZ = xyz;
+    return BuildGrid();
+}
+
+void CNeighbourSearch::GetBinIndexes(const Vector3D &xyz, long index[3]) const
+{
+    for (DWORD k = 0; k < 3; k++)
+    {
+        long i = (long)floor((xyz.X(k) - gridMin.X(k)) / binSize);
+        index[k] = MAX(0L, MIN(i, dims[k] - 1));
+    }
+}
+
+ERR CNeighbourSearch::BuildGrid()
+{
+    binAtoms.clear();
+    binStart.clear();
+    Vector3DBox Box;
+    for (DWORD i = 0; i < nAtoms; i++)
+        Box.AddVector(atomXYZ[i]);
+    gridMin = nAtoms ? Box.GetBoxCornerMin() : Vector3D();
+    Vector3D Extent = nAtoms ? Box.GetBoxCornerMax() - gridMin : Vector3D();
+
+    // Bins are never smaller than the cutoff, but sparse sets of atoms get
+    // coarser bins to keep the grid proportional to the number of atoms
+    binSize = cutoff;
+    double maxBins = MAX(1.0, (double)nAtoms * NEIGHBOUR_BINS_PER_ATOM);
+    for (;;)
+    {
+        double nBins = 1;
+        for (DWORD k = 0; k < 3; k++)
+        {
+            dims[k] = (long)floor(Extent.X(k) / binSize) + 1;
+            nBins *= dims[k];
+        }
+        if (nBins <= maxBins)
+            break;
+        binSize *= MAX(1.1, pow(nBins / maxBins, 1.0 / 3.0));
+    }
+
+    // Counting sort of the atoms by bin
+    DWORD nBins = dims[0] * dims[1] * dims[2];
+    vector<DWORD> atomBins(nAtoms);
+    binStart.assign(nBins + 1, 0);
+    long index[3];
+    for (DWORD i = 0; i < nAtoms; i++)
+    {
+        GetBinIndexes(atomXYZ[i], index);
+        atomBins[i] = (index[2] * dims[1] + index[1]) * dims[0] + index[0];
+        binStart[atomBins[i] + 1]++;
+    }
+    for (DWORD b = 0; b < nBins; b++)
+        binStart[b + 1] += binStart[b];
+    vector<DWORD> next(binStart.begin(), binStart.end() - 1);
+    binAtoms.resize(nAtoms);
+    for (DWORD i = 0; i < nAtoms; i++)
+        binAtoms[next[atomBins[i]]++] = i;
+    return NULL;
+}
+
+ERR CNeighbourSearch::FindPairs(DWORD first, DWORD last, vector<CNeighbourPair> &pairs) const
+{
+    double cutoff2 = cutoff * cutoff;
+    vector<CNeighbourPair> atomPairs;
+    CNeighbourPair Pair;
+    long index[3];
+    for (DWORD i = first; i < last; i++)
+    {
+        const Vector3D &xyz = atomXYZ[i];
+        GetBinIndexes(xyz, index);
+        atomPairs.clear();
+        for (long z = MAX(0L, index[2] - 1); z <= MIN(dims[2] - 1, index[2] + 1); z++)
+            for (long y = MAX(0L, index[1] - 1); y <= MIN(dims[1] - 1, index[1] + 1); y++)
+            {
+                // Bins along x are consecutive, so a row of three bins is one range
+                DWORD row = (z * dims[1] + y) * dims[0];
+                DWORD from = binStart[row + MAX(0L, index[0] - 1)];
+                DWORD to = binStart[row + MIN(dims[0] - 1, index[0] + 1) + 1];
+                for (DWORD p = from; p < to; p++)
+                {
+                    DWORD j = binAtoms[p];
+                    // Each pair is reported from its first atom only
+                    if (j <= i)
+                        continue;
+                    double d2 = (atomXYZ[j] - xyz).Len2();
+                    if (d2 > cutoff2)
+                        continue;
+                    Pair.atom1 = i;
+                    Pair.atom2 = j;
+                    Pair.distance = sqrt(d2);
+                    atomPairs.push_back(Pair);
+                }
+            }
+        sort(atomPairs.begin(), atomPairs.end(), IsPairLess);
+        pairs.insert(pairs.end(), atomPairs.begin(), atomPairs.end());
+    }
+    return NULL;
+}
+
+ERR CNeighbourSearch::FindPairs(DWORD workers, vector<CNeighbourPair> &pairs) const
+{
+    CTaskPool pool(workers);
+    // Several ranges per worker, as the density of the atoms is not uniform
+    DWORD nRanges = MIN(nAtoms, pool.GetWorkers() * 8);
+    vector<CTask*> tasks;
+    for (DWORD r = 0; r < nRanges; r++)
+        tasks.push_back(new CPairSearchTask(*this,
+                                            (DWORD)((DWORD64)nAtoms * r / nRanges),
+                                            (DWORD)((DWORD64)nAtoms * (r + 1) / nRanges)));
+    ERR err = pool.Run(tasks);
+    if (!err)
+        for (DWORD r = 0; r < tasks.size(); r++)
+        {
+            const vector<CNeighbourPair> &range = ((CPairSearchTask *)tasks[r])->pairs;
+            pairs.insert(pairs.end(), range.begin(), range.end());
+        }
+    DestroyPtrVector(tasks);
+    return err;
+}
@@ -0,0 +1,309 @@
+#include "ParticleIndex.h"
+
+#include <stdexcept>
+
+static const char *pERRSpeciesCode = "Chemical specie code out of range";
+static const char *pERRLabelCode = "Label code out of range";
+static const char *pERRContainer = "Unknown error of the particle container";
+
+//==============================================================================
+CUuid CParticleIndex::ParseID(const ID_TYPE &id)
+{
+    CUuid Uuid;
+    if (!UuidFromHex(id, Uuid))
+        throw runtime_error("Not a UUID: " + id);
+    return Uuid;
+}
+
+void CParticleIndex::SetParticle(const CUuid &Uuid, CNCadParticle *pParticle)
+{
+    particles.Set(Uuid, pParticle);
+    ids.RemoveUuid(Uuid);
+    if (pParticle)
+        ids.Set(pParticle->ID, Uuid);
+}
+
+void CParticleIndex::Rebuild()
+{
+    particles.Clear();
+    bonds.Clear();
+    ids.Clear();
+    stale = FALSE;
+    particles.Reserve(container.particles.size());
+    ids.Reserve(container.particles.size());
+    bonds.Reserve(container.bonds.size());
+    CUuid Uuid;
+    // The ids that are not UUIDs cannot be looked up by bytes, so they are left out
+    for (map<ID_TYPE, CNCadParticle *>::iterator it = container.particles.begin(); it != container.particles.end(); ++it)
+        if (UuidFromHex(it->first, Uuid))
+            SetParticle(Uuid, it->second);
+    for (map<ID_TYPE, CNCadBond *>::iterator it = container.bonds.begin(); it != container.bonds.end(); ++it)
+        if (UuidFromHex(it->first, Uuid))
+            bonds.Set(Uuid, it->second);
+}
+
+void CParticleIndex::RebuildIfStale() const
+{
+    if (stale)
+        const_cast<CParticleIndex *>(this)->Rebuild();
+}
+
+CNCadParticle * CParticleIndex::GetParticle(const BYTE *uuid) const
+{
+    RebuildIfStale();
+    CNCadParticle * const *ppParticle = particles.Find(UuidFromBytes(uuid));
+    return ppParticle ? *ppParticle : NULL;
+}
+
+CNCadBond * CParticleIndex::GetBond(const BYTE *uuid) const
+{
+    RebuildIfStale();
+    CNCadBond * const *ppBond = bonds.Find(UuidFromBytes(uuid));
+    return ppBond ? *ppBond : NULL;
+}
+
+//==============================================================================
+void CParticleIndex::AddParticle(CParticleInfo &partInfo)
+{
+    RebuildIfStale();
+    CUuid Uuid = ParseID(partInfo.id);
+    if (particles.Has(Uuid))
+        throw runtime_error("Duplicated particle: " + partInfo.id);
+    AddParticle(Uuid, partInfo);
+}
+
+void CParticleIndex::AddParticle(const CUuid &Uuid, CParticleInfo &partInfo)
+{
+    container.AddParticle(partInfo);
+    // The container creates the particle, which is taken from its map once
+    map<ID_TYPE, CNCadParticle *>::iterator it = container.particles.find(partInfo.id);
+    SetParticle(Uuid, it != container.particles.end() ? it->second : NULL);
+}
+
+void CParticleIndex::AddBond(CBondInfo &bondInfo)
+{
+    RebuildIfStale();
+    CUuid Uuid = ParseID(bondInfo.id);
+    if (bonds.Has(Uuid))
+        throw runtime_error("Duplicated bond: " + bondInfo.id);
+    container.AddBond(bondInfo);
+    map<ID_TYPE, CNCadBond *>::iterator it = container.bonds.find(bondInfo.id);
+    bonds.Set(Uuid, it != container.bonds.end() ? it->second : NULL);
+}
+
+void CParticleIndex::UpdateParticle(CParticleInfo &partInfo)
+{
+    RebuildIfStale();
+    UpdateParticle(ParseID(partInfo.id), partInfo);
+}
+
+void CParticleIndex::UpdateParticle(const CUuid &Uuid, CParticleInfo &partInfo)
+{
+    container.UpdateParticle(partInfo);
+    // The container may replace the particle object
+    map<ID_TYPE, CNCadParticle *>::iterator it = container.particles.find(partInfo.id);
+    if (it != container.particles.end())
+        SetParticle(Uuid, it->second);
+}
+
+void CParticleIndex::UpdateBond(CBondInfo &bondInfo)
+{
+    RebuildIfStale();
+    container.UpdateBond(bondInfo);
+    map<ID_TYPE, CNCadBond *>::iterator it = container.bonds.find(bondInfo.id);
+    if (it != container.bonds.end())
+        bonds.Set(ParseID(bondInfo.id), it->second);
+}
+
+void CParticleIndex::RemoveParticle(const BYTE *uuid)
+{
+    RebuildIfStale();
+    CUuid Uuid = UuidFromBytes(uuid);
+    container.RemoveParticle(UuidToHex(Uuid));
+    particles.Remove(Uuid);
+    ids.RemoveUuid(Uuid);
+}
+
+void CParticleIndex::RemoveBond(const BYTE *uuid)
+{
+    RebuildIfStale();
+    CUuid Uuid = UuidFromBytes(uuid);
+    container.RemoveBond(UuidToHex(Uuid));
+    bonds.Remove(Uuid);
+}
+
+//==============================================================================
+ERR CParticleIndex::SetError(const string &message)
+{
+    error = message;
+    return error.c_str();
+}
+
+const NC_Atom * CParticleIndex::GetAtom(const CNCadParticle &Particle) const
+{
+    // The atoms are kept by the nCad object of the container, which the index only reads
+    CNCadComponent *pNCadComponent = dynamic_cast<CNCadComponent *>(&container);
+    if (pNCadComponent)
+        return pNCadComponent->pComponent ? pNCadComponent->pComponent->GetAtomByID(Particle.ID) : NULL;
+    CNCadCell *pNCadCell = dynamic_cast<CNCadCell *>(&container);
+    if (pNCadCell)
+        return pNCadCell->pCell ? pNCadCell->pCell->GetAtomByID(Particle.ID) : NULL;
+    return NULL;
+}
+
+void CParticleIndex::GetParticleInfo(DWORD i, const CUuid &Uuid, const double *xyz, const int *species,
+    const int *labels, const vector<string> &speciesNames, const vector<string> &labelNames,
+    CParticleInfo &partInfo)
+{
+    UuidToHex(Uuid, partInfo.id);
+    partInfo.x = xyz[3 * i];
+    partInfo.y = xyz[3 * i + 1];
+    partInfo.z = xyz[3 * i + 2];
+    partInfo.specie = speciesNames[species[i]];
+    partInfo.label = labelNames[labels[i]];
+    partInfo.occupancy = 1;
+}
+
+ERR CParticleIndex::CheckParticles(DWORD n, const BYTE *uuids, const int *species, const int *labels,
+    DWORD nSpecies, DWORD nLabels, BOOL existing)
+{
+    RebuildIfStale();
+    CUuidMap<BYTE> batch;
+    if (!existing)
+        batch.Reserve(n);
+    for (DWORD i = 0; i < n; i++)
+    {
+        CUuid Uuid = UuidFromBytes(uuids + UUID_BYTES * i);
+        BOOL found = particles.Has(Uuid);
+        if (found && !existing)
+            return SetError("Duplicated particle: " + UuidToHex(Uuid));
+        if (!found && existing)
+            return SetError("Particle not found: " + UuidToHex(Uuid));
+        // A particle added twice in the same call is also a duplicate
+        if (!existing && !batch.Insert(Uuid, 0))
+            return SetError("Duplicated particle: " + UuidToHex(Uuid));
+        if (species[i] < 0 || (DWORD)species[i] >= nSpecies)
+            return pERRSpeciesCode;
+        if (labels[i] < 0 || (DWORD)labels[i] >= nLabels)
+            return pERRLabelCode;
+    }
+    return NULL;
+}
+
+ERR CParticleIndex::AddParticles(DWORD n, const BYTE *uuids, const double *xyz, const int *species,
+    const int *labels, const vector<string> &speciesNames, const vector<string> &labelNames)
+{
+    ERR err = CheckParticles(n, uuids, species, labels, speciesNames.size(), labelNames.size(), FALSE);
+    if (err)
+        return err;
+    particles.Reserve(particles.GetSize() + n);
+    ids.Reserve(ids.GetSize() + n);
+    CParticleInfo partInfo;
+    try
+    {
+        for (DWORD i = 0; i < n; i++)
+        {
+            CUuid Uuid = UuidFromBytes(uuids + UUID_BYTES * i);
+            GetParticleInfo(i, Uuid, xyz, species, labels, speciesNames, labelNames, partInfo);
+            AddParticle(Uuid, partInfo);
+        }
+    }
+    catch (exception &e)
+    {
+        return SetError(e.what());
+    }
+    catch (...)
+    {
+        return pERRContainer;
+    }
+    return NULL;
+}
+
+ERR CParticleIndex::UpdateParticles(DWORD n, const BYTE *uuids, const double *xyz, const int *species,
+    const int *labels, const vector<string> &speciesNames, const vector<string> &labelNames)
+{
+    ERR err = CheckParticles(n, uuids, species, labels, speciesNames.size(), labelNames.size(), TRUE);
+    if (err)
+        return err;
+    CParticleInfo partInfo;
+    try
+    {
+        for (DWORD i = 0; i < n; i++)
+        {
+            CUuid Uuid = UuidFromBytes(uuids + UUID_BYTES * i);
+            GetParticleInfo(i, Uuid, xyz, species, labels, speciesNames, labelNames, partInfo);
+            UpdateParticle(Uuid, partInfo);
+        }
+    }
+    catch (exception &e)
+    {
+        return SetError(e.what());
+    }
+    catch (...)
+    {
+        return pERRContainer;
+    }
+    return NULL;
+}
+
+ERR CParticleIndex::GetParticles(DWORD n, const BYTE *uuids, double *xyz, int *species, int *labels,
+    double *occupancies, CSymbolTable &speciesNames, CSymbolTable &labelNames)
+{
+    RebuildIfStale();
+    try
+    {
+        for (DWORD i = 0; i < n; i++)
+        {
+            CUuid Uuid = UuidFromBytes(uuids + UUID_BYTES * i);
+            CNCadParticle * const *ppParticle = particles.Find(Uuid);
+            const NC_Atom *pAtom = ppParticle && *ppParticle ? GetAtom(**ppParticle) : NULL;
+            if (!pAtom)
+                return SetError("Particle not found: " + UuidToHex(Uuid));
+            xyz[3 * i] = pAtom->xyz.x;
+            xyz[3 * i + 1] = pAtom->xyz.y;
+            xyz[3 * i + 2] = pAtom->xyz.z;
+            species[i] = speciesNames.Intern(pAtom->Element);
+            labels[i] = labelNames.Intern(pAtom->Label);
+            occupancies[i] = pAtom->Occupancy;
+        }
+    }
+    catch (exception &e)
+    {
+        return SetError(e.what());
+    }
+    catch (...)
+    {
+        return pERRContainer;
+    }
+    return NULL;
+}
+
+ERR CParticleIndex::RemoveParticles(DWORD n, const BYTE *uuids)
+{
+    RebuildIfStale();
+    // A particle removed twice in the same call would not be found the second time
+    CUuidMap<BYTE> batch;
+    batch.Reserve(n);
+    for (DWORD i = 0; i < n; i++)
+    {
+        CUuid Uuid = UuidFromBytes(uuids + UUID_BYTES * i);
+        if (!particles.Has(Uuid))
+            return SetError("Particle not found: " + UuidToHex(Uuid));
+        if (!batch.Insert(Uuid, 0))
+            return SetError("Duplicated particle: " + UuidToHex(Uuid));
+    }
+    try
+    {
+        for (DWORD i = 0; i < n; i++)
+            RemoveParticle(uuids + UUID_BYTES * i);
+    }
+    catch (exception &e)
+    {
+        return SetError(e.what());
+    }
+    catch (...)
+    {
+        return pERRContainer;
+    }
+    return NULL;
+}
@@ -0,0 +1,99 @@
+#include "Sha1.h"
+#include "Service.h"
+
+#include <cstring>
+
+#define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+//==============================================================================
+void CSha1::Reset()
+{
+    state[0] = 0x67452301;
+    state[1] = 0xEFCDAB89;
+    state[2] = 0x98BADCFE;
+    state[3] = 0x10325476;
+    state[4] = 0xC3D2E1F0;
+    length = 0;
+}
+
+void CSha1::Update(const BYTE *data, DWORD size)
+{
+    DWORD used = (DWORD)(length % 64);
+    length += size;
+    if (used)
+    {
+        DWORD n = MIN(size, 64 - used);
+        memcpy(block + used, data, n);
+        data += n;
+        size -= n;
+        if (used + n < 64)
+            return;
+        Transform(block);
+    }
+    for (; size >= 64; data += 64, size -= 64)
+        Transform(data);
+    memcpy(block, data, size);
+}
+
+void CSha1::Final(BYTE *digest)
+{
+    DWORD64 bits = length * 8;
+    BYTE padding[72];
+    DWORD used = (DWORD)(length % 64);
+    // A 1 bit, zeros up to 56 bytes of the last block and the length in bits
+    DWORD n = (used < 56 ? 56 : 120) - used;
+    memset(padding, 0, n);
+    padding[0] = 0x80;
+    for (DWORD i = 0; i < 8; i++)
+        padding[n + i] = (BYTE)(bits >> (56 - 8 * i));
+    Update(padding, n + 8);
+    for (DWORD i = 0; i < SHA1_BYTES; i++)
+        digest[i] = (BYTE)(state[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+void CSha1::Transform(const BYTE *data)
+{
+    DWORD w[80];
+    for (DWORD i = 0; i < 16; i++)
+        w[i] = ((DWORD)data[4 * i] << 24) | ((DWORD)data[4 * i + 1] << 16) |
+            ((DWORD)data[4 * i + 2] << 8) | data[4 * i + 3];
+    for (DWORD i = 16; i < 80; i++)
+        w[i] = ROTATE_LEFT(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    DWORD a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (DWORD i = 0; i < 80; i++)
+    {
+        DWORD f, k;
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        }
+        else if (i < 40)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        }
+        else
+        {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        DWORD t = ROTATE_LEFT(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = ROTATE_LEFT(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
@@ -0,0 +1,285 @@
+#include "SpatialOrder.h"
+#include "TaskPool.h"
+
+/**Number of bits of the digits of the radix sort.*/
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+/**Below this number of keys per range the radix sort and the keys are computed serially.*/
+#define SPATIAL_MIN_RANGE 16384
+
+static const char *pERRSpatialBonds = "The bonds are not built over the atoms to sort";
+
+//==============================================================================
+/**Spreads the lower SPATIAL_KEY_BITS bits of a coordinate so there are two zero bits
+between each of them.*/
+static DWORD64 SpreadBits(DWORD64 v)
+{
+    v &= 0x1FFFFF;
+    v = (v | (v << 32)) & 0x1F00000000FFFFULL;
+    v = (v | (v << 16)) & 0x1F0000FF0000FFULL;
+    v = (v | (v << 8)) & 0x100F00F00F00F00FULL;
+    v = (v | (v << 4)) & 0x10C30C30C30C30C3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+static DWORD64 GetMortonKey(DWORD X[3])
+{
+    return SpreadBits(X[0]) | (SpreadBits(X[1]) << 1) | (SpreadBits(X[2]) << 2);
+}
+
+/**Hilbert key by the transposition of Skilling ("Programming the Hilbert curve", 2004):
+the coordinates are turned into the transposed Hilbert index in place, whose bits
+interleaved (the first axis the most significant) are the index.*/
+static DWORD64 GetHilbertKey(DWORD X[3])
+{
+    DWORD M = 1 << (SPATIAL_KEY_BITS - 1);
+    for (DWORD Q = M; Q > 1; Q >>= 1)
+    {
+        DWORD P = Q - 1;
+        for (DWORD i = 0; i < 3; i++)
+            if (X[i] & Q)
+                X[0] ^= P;
+            else
+            {
+                DWORD t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+    }
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+    DWORD t = 0;
+    for (DWORD Q = M; Q > 1; Q >>= 1)
+        if (X[2] & Q)
+            t ^= Q - 1;
+    for (DWORD i = 0; i < 3; i++)
+        X[i] ^= t;
+    return SpreadBits(X[2]) | (SpreadBits(X[1]) << 1) | (SpreadBits(X[0]) << 2);
+}
+
+/**Splits n items in ranges for the workers, one range if there are few.*/
+static void SplitKeyRanges(DWORD n, DWORD workers, vector<DWORD> &bounds)
+{
+    DWORD nRanges = MAX(MIN(n / SPATIAL_MIN_RANGE, workers * 4), (DWORD)1);
+    bounds.resize(nRanges + 1);
+    for (DWORD r = 0; r <= nRanges; r++)
+        bounds[r] = (DWORD)((DWORD64)n * r / nRanges);
+}
+
+/**Runs the tasks in the pool if there are several, and deletes them.*/
+static void RunTasks(CTaskPool *&pPool, DWORD workers, vector<CTask*> &tasks)
+{
+    if (tasks.size() == 1)
+        tasks[0]->Run();
+    else
+    {
+        if (!pPool)
+            pPool = new CTaskPool(workers);
+        pPool->Run(tasks);
+    }
+}
+
+//==============================================================================
+class CSpatialKeyTask : public CTask
+/**Task that computes the keys of a range of points.*/
+{
+    const CPointArray &points;
+    SpatialOrderType type;
+    const double *min;
+    double scale;
+    DWORD64 *keys;
+    DWORD begin;
+    DWORD end;
+public:
+    CSpatialKeyTask(const CPointArray &aPoints, SpatialOrderType aType, const double *aMin, double aScale,
+                    DWORD64 *aKeys, DWORD aBegin, DWORD aEnd) :
+        points(aPoints), type(aType), min(aMin), scale(aScale), keys(aKeys), begin(aBegin), end(aEnd) {}
+    ERR Run()
+    {
+        const vector<double> *coords[3] = {&points.x, &points.y, &points.z};
+        for (DWORD i = begin; i < end; i++)
+        {
+            DWORD X[3];
+            for (DWORD c = 0; c < 3; c++)
+            {
+                double v = ((*coords[c])[i] - min[c]) * scale;
+                X[c] = v > 0 ? MIN((DWORD)v, (DWORD)((1 << SPATIAL_KEY_BITS) - 1)) : 0;
+            }
+            keys[i] = type == spatialOrderHilbert ? GetHilbertKey(X) : GetMortonKey(X);
+        }
+        return NULL;
+    }
+};
+
+void GetSpatialKeys(const CPointArray &Points, SpatialOrderType type, vector<DWORD64> &keys, DWORD workers)
+{
+    DWORD n = Points.GetSize();
+    keys.resize(n);
+    if (type == spatialOrderNone)
+    {
+        for (DWORD i = 0; i < n; i++)
+            keys[i] = i;
+        return;
+    }
+    if (n == 0)
+        return;
+    double min[3] = {MAX_DOUBLE, MAX_DOUBLE, MAX_DOUBLE};
+    double max[3] = {-MAX_DOUBLE, -MAX_DOUBLE, -MAX_DOUBLE};
+    const vector<double> *coords[3] = {&Points.x, &Points.y, &Points.z};
+    for (DWORD c = 0; c < 3; c++)
+        for (DWORD i = 0; i < n; i++)
+        {
+            min[c] = MIN(min[c], (*coords[c])[i]);
+            max[c] = MAX(max[c], (*coords[c])[i]);
+        }
+    double extent = MAX(MAX(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+    double scale = extent > 0 ? ((1 << SPATIAL_KEY_BITS) - 1) / extent : 0;
+
+    vector<DWORD> bounds;
+    SplitKeyRanges(n, workers ? workers : CTaskPool::GetDefaultWorkers(), bounds);
+    vector<CTask*> tasks;
+    for (DWORD r = 0; r + 1 < bounds.size(); r++)
+        tasks.push_back(new CSpatialKeyTask(Points, type, min, scale, &keys[0], bounds[r], bounds[r + 1]));
+    CTaskPool *pPool = NULL;
+    RunTasks(pPool, workers, tasks);
+    delete pPool;
+    DestroyPtrVector(tasks);
+}
+
+//==============================================================================
+class CRadixTask : public CTask
+/**Task that counts the digits of a range of keys, or scatters them to their positions
+once the counts of all the ranges are turned into offsets.*/
+{
+public:
+    /**Keys and indexes read and written by the pass.*/
+    const DWORD64 *srcKeys;
+    const DWORD *srcIndexes;
+    DWORD64 *dstKeys;
+    DWORD *dstIndexes;
+    DWORD shift;
+    BOOL scatter;
+    /**Number of keys of each digit in the range, then the position of the next one.*/
+    DWORD counts[RADIX_SIZE];
+
+    CRadixTask(DWORD aBegin, DWORD aEnd) : srcKeys(NULL), srcIndexes(NULL), dstKeys(NULL),
+        dstIndexes(NULL), shift(0), scatter(FALSE), begin(aBegin), end(aEnd) {}
+    ERR Run()
+    {
+        if (!scatter)
+        {
+            for (DWORD d = 0; d < RADIX_SIZE; d++)
+                counts[d] = 0;
+            for (DWORD i = begin; i < end; i++)
+                counts[(srcKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            return NULL;
+        }
+        for (DWORD i = begin; i < end; i++)
+        {
+            DWORD position = counts[(srcKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            dstKeys[position] = srcKeys[i];
+            dstIndexes[position] = srcIndexes[i];
+        }
+        return NULL;
+    }
+    double GetCost() const { return end - begin; }
+private:
+    DWORD begin;
+    DWORD end;
+};
+
+void RadixSortKeys(const vector<DWORD64> &keys, vector<DWORD> &order, DWORD workers)
+{
+    DWORD n = keys.size();
+    order.resize(n);
+    for (DWORD i = 0; i < n; i++)
+        order[i] = i;
+    if (n < 2)
+        return;
+    DWORD64 all = 0;
+    for (DWORD i = 0; i < n; i++)
+        all |= keys[i];
+
+    vector<DWORD64> sortedKeys(keys);
+    vector<DWORD64> tempKeys(n);
+    vector<DWORD> tempOrder(n);
+    vector<DWORD> bounds;
+    SplitKeyRanges(n, workers ? workers : CTaskPool::GetDefaultWorkers(), bounds);
+    vector<CRadixTask*> ranges;
+    for (DWORD r = 0; r + 1 < bounds.size(); r++)
+        ranges.push_back(new CRadixTask(bounds[r], bounds[r + 1]));
+    vector<CTask*> tasks(ranges.begin(), ranges.end());
+    CTaskPool *pPool = NULL;
+
+    // The digits above the highest bit set in any key are all zero and are skipped
+    for (DWORD shift = 0; shift < 64 && (all >> shift); shift += RADIX_BITS)
+    {
+        for (DWORD r = 0; r < ranges.size(); r++)
+        {
+            ranges[r]->srcKeys = &sortedKeys[0];
+            ranges[r]->srcIndexes = &order[0];
+            ranges[r]->dstKeys = &tempKeys[0];
+            ranges[r]->dstIndexes = &tempOrder[0];
+            ranges[r]->shift = shift;
+            ranges[r]->scatter = FALSE;
+        }
+        RunTasks(pPool, workers, tasks);
+
+        // The keys of a digit go after the ones of the smaller digits, and in each digit
+        // the ones of a range after the ones of the previous ranges, so the sort is stable
+        DWORD position = 0;
+        BOOL single = FALSE;
+        for (DWORD d = 0; d < RADIX_SIZE; d++)
+        {
+            DWORD total = 0;
+            for (DWORD r = 0; r < ranges.size(); r++)
+            {
+                DWORD count = ranges[r]->counts[d];
+                ranges[r]->counts[d] = position + total;
+                total += count;
+            }
+            single = single || total == n;
+            position += total;
+        }
+        // A digit shared by all the keys leaves the order as it is
+        if (single)
+            continue;
+        for (DWORD r = 0; r < ranges.size(); r++)
+            ranges[r]->scatter = TRUE;
+        RunTasks(pPool, workers, tasks);
+        sortedKeys.swap(tempKeys);
+        order.swap(tempOrder);
+    }
+    delete pPool;
+    DestroyPtrVector(ranges);
+}
+
+void GetSpatialOrder(const CPointArray &Points, SpatialOrderType type, vector<DWORD> &order, DWORD workers)
+{
+    if (type == spatialOrderNone)
+    {
+        order.resize(Points.GetSize());
+        for (DWORD i = 0; i < order.size(); i++)
+            order[i] = i;
+        return;
+    }
+    vector<DWORD64> keys;
+    GetSpatialKeys(Points, type, keys, workers);
+    RadixSortKeys(keys, order, workers);
+}
+
+//==============================================================================
+ERR SortSpatially(CAtomStore &atoms, CBondStore &bonds, SpatialOrderType type, DWORD workers)
+{
+    if (bonds.GetNBonds() && bonds.GetNAtoms() != atoms.GetSize())
+        return pERRSpatialBonds;
+    if (type == spatialOrderNone)
+        return NULL;
+    vector<DWORD> order;
+    GetSpatialOrder(atoms.GetPoints(), type, order, workers);
+    atoms.Reorder(order);
+    if (bonds.GetNAtoms() == atoms.GetSize())
+        bonds.Reorder(order);
+    return NULL;
+}
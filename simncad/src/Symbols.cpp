@@ -0,0 +1,72 @@
+#include "Symbols.h"
+
+#include <ctype.h>
+
+/**Symbols of the elements, by atomic number.*/
+static const char *ElementSymbols[elementMAX] =
+{
+    "", "H", "He", "Li", "Be", "B", "C", "N", "O", "F", "Ne", "Na", "Mg", "Al", "Si", "P",
+    "S", "Cl", "Ar", "K", "Ca", "Sc", "Ti", "V", "Cr", "Mn", "Fe", "Co", "Ni", "Cu", "Zn",
+    "Ga", "Ge", "As", "Se", "Br", "Kr", "Rb", "Sr", "Y", "Zr", "Nb", "Mo", "Tc", "Ru", "Rh",
+    "Pd", "Ag", "Cd", "In", "Sn", "Sb", "Te", "I", "Xe", "Cs", "Ba", "La", "Ce", "Pr", "Nd",
+    "Pm", "Sm", "Eu", "Gd", "Tb", "Dy", "Ho", "Er", "Tm", "Yb", "Lu", "Hf", "Ta", "W", "Re",
+    "Os", "Ir", "Pt", "Au", "Hg", "Tl", "Pb", "Bi", "Po", "At", "Rn", "Fr", "Ra", "Ac",
+    "Th", "Pa", "U", "Np", "Pu", "Am", "Cm", "Bk", "Cf", "Es", "Fm", "Md", "No", "Lr", "Rf",
+    "Db", "Sg", "Bh", "Hs", "Mt", "Ds", "Rg", "Cn", "Nh", "Fl", "Mc", "Lv", "Ts", "Og"
+};
+
+//==============================================================================
+ElementNumber GetElementNumber(const string &species)
+{
+    // The symbol is the leading letters, and only a charge may follow it
+    size_t len = 0;
+    while (len < species.size() && isalpha((BYTE)species[len]))
+        len++;
+    if (len == 0 || len > 2)
+        return elementNone;
+    for (size_t i = len; i < species.size(); i++)
+        if (!isdigit((BYTE)species[i]) && species[i] != '+' && species[i] != '-')
+            return elementNone;
+
+    for (DWORD e = elementNone + 1; e < elementMAX; e++)
+    {
+        const char *pSymbol = ElementSymbols[e];
+        size_t i = 0;
+        while (i < len && pSymbol[i] && tolower((BYTE)species[i]) == tolower((BYTE)pSymbol[i]))
+            i++;
+        if (i == len && !pSymbol[i])
+            return (ElementNumber)e;
+    }
+    return elementNone;
+}
+
+const string & GetElementSymbol(ElementNumber element)
+{
+    // Built on first use; the strings are never modified afterwards
+    static vector<string> Symbols(ElementSymbols, ElementSymbols + elementMAX);
+    return Symbols[element < elementMAX ? element : elementNone];
+}
+
+//==============================================================================
+DWORD CSymbolTable::Intern(const string &name)
+{
+    map<string, DWORD>::iterator it = indexes.find(name);
+    if (it != indexes.end())
+        return it->second;
+    DWORD index = names.size();
+    names.push_back(name);
+    indexes[name] = index;
+    return index;
+}
+
+DWORD CSymbolTable::Find(const string &name) const
+{
+    map<string, DWORD>::const_iterator it = indexes.find(name);
+    return it == indexes.end() ? SYMBOL_NONE : it->second;
+}
+
+void CSymbolTable::Clear()
+{
+    names.clear();
+    indexes.clear();
+}
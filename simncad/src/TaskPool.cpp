@@ -0,0 +1,164 @@
+#include "TaskPool.h"
+#include "Service.h"
+
+#include <algorithm>
+#include <exception>
+
+static const char *pERRTaskUnknownException = "Unknown exception in a parallel task";
+
+/**Orders task indexes by decreasing estimated cost.*/
+class CTaskCostGreater
+{
+    const vector<CTask*> &tasks;
+public:
+    CTaskCostGreater(const vector<CTask*> &aTasks) : tasks(aTasks) {}
+    bool operator() (DWORD a, DWORD b) const
+    {
+        return tasks[a]->GetCost() > tasks[b]->GetCost();
+    }
+};
+
+CTaskPool::CTaskPool(DWORD aWorkers) : workers(aWorkers), pTasks(NULL)
+{
+    if (workers == 0)
+        workers = GetDefaultWorkers();
+}
+
+CTaskPool::~CTaskPool()
+{
+}
+
+DWORD CTaskPool::GetDefaultWorkers()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+ERR CTaskPool::Run(const vector<CTask*> &tasks)
+{
+    DWORD n = tasks.size();
+    DWORD nWorkers = MIN(workers, n);
+    if (nWorkers <= 1)
+    {
+        for (DWORD i = 0; i < n; i++)
+            RETURN_IF_ERR(tasks[i]->Run());
+        return NULL;
+    }
+
+    pTasks = &tasks;
+    results.assign(n, (ERR)NULL);
+    messages.assign(n, string());
+
+    vector<DWORD> order(n);
+    for (DWORD i = 0; i < n; i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), CTaskCostGreater(tasks));
+
+    queues.resize(nWorkers);
+    for (DWORD w = 0; w < nWorkers; w++)
+    {
+        queues[w] = new CWorkerQueue;
+        InitializeCriticalSection(&queues[w]->lock);
+    }
+    for (DWORD i = 0; i < n; i++)
+        queues[i % nWorkers]->tasks.push_back(order[i]);
+
+    // Worker 0 is the calling thread. If a thread can't be created its queue
+    // is simply drained by the others through stealing.
+    vector<CWorkerParam> params(nWorkers);
+    vector<HANDLE> threads;
+    for (DWORD w = 1; w < nWorkers; w++)
+    {
+        params[w].pPool = this;
+        params[w].worker = w;
+        HANDLE hThread = CreateThread(NULL, 0, WorkerProc, &params[w], 0, NULL);
+        if (hThread)
+            threads.push_back(hThread);
+    }
+    WorkerLoop(0);
+    for (DWORD i = 0; i < threads.size(); i++)
+    {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+
+    for (DWORD w = 0; w < nWorkers; w++)
+    {
+        DeleteCriticalSection(&queues[w]->lock);
+        delete queues[w];
+    }
+    queues.clear();
+    pTasks = NULL;
+
+    for (DWORD i = 0; i < n; i++)
+        if (results[i])
+            return results[i];
+    return NULL;
+}
+
+BOOL CTaskPool::PopOwn(DWORD worker, DWORD &task)
+{
+    CWorkerQueue *pQueue = queues[worker];
+    BOOL found = FALSE;
+    EnterCriticalSection(&pQueue->lock);
+    if (!pQueue->tasks.empty())
+    {
+        task = pQueue->tasks.front();
+        pQueue->tasks.pop_front();
+        found = TRUE;
+    }
+    LeaveCriticalSection(&pQueue->lock);
+    return found;
+}
+
+BOOL CTaskPool::Steal(DWORD worker, DWORD &task)
+{
+    DWORD n = queues.size();
+    for (DWORD k = 1; k < n; k++)
+    {
+        CWorkerQueue *pQueue = queues[(worker + k) % n];
+        BOOL found = FALSE;
+        EnterCriticalSection(&pQueue->lock);
+        if (!pQueue->tasks.empty())
+        {
+            task = pQueue->tasks.back();
+            pQueue->tasks.pop_back();
+            found = TRUE;
+        }
+        LeaveCriticalSection(&pQueue->lock);
+        if (found)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+void CTaskPool::WorkerLoop(DWORD worker)
+{
+    // Tasks never create new tasks, so when there is nothing to pop or steal
+    // all the remaining work is already being executed by other workers.
+    DWORD task;
+    while (PopOwn(worker, task) || Steal(worker, task))
+    {
+        try
+        {
+            results[task] = (*pTasks)[task]->Run();
+        }
+        catch (exception &e)
+        {
+            messages[task] = e.what();
+            results[task] = messages[task].c_str();
+        }
+        catch (...)
+        {
+            results[task] = pERRTaskUnknownException;
+        }
+    }
+}
+
+DWORD WINAPI CTaskPool::WorkerProc(LPVOID pParam)
+{
+    CWorkerParam *pWorkerParam = (CWorkerParam *)pParam;
+    pWorkerParam->pPool->WorkerLoop(pWorkerParam->worker);
+    return 0;
+}
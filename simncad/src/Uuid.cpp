@@ -0,0 +1,83 @@
+#include "Uuid.h"
+#include "Sha1.h"
+
+//==============================================================================
+CUuid UuidFromBytes(const BYTE *bytes)
+{
+    CUuid Uuid;
+    Uuid.high = Uuid.low = 0;
+    for (DWORD i = 0; i < 8; i++)
+    {
+        Uuid.high = (Uuid.high << 8) | bytes[i];
+        Uuid.low = (Uuid.low << 8) | bytes[8 + i];
+    }
+    return Uuid;
+}
+
+void UuidToBytes(const CUuid &Uuid, BYTE *bytes)
+{
+    for (DWORD i = 0; i < 8; i++)
+    {
+        bytes[i] = (BYTE)(Uuid.high >> (56 - 8 * i));
+        bytes[8 + i] = (BYTE)(Uuid.low >> (56 - 8 * i));
+    }
+}
+
+BOOL UuidFromHex(const string &hex, CUuid &Uuid)
+{
+    DWORD digits = 0;
+    Uuid.high = Uuid.low = 0;
+    for (DWORD i = 0; i < hex.size(); i++)
+    {
+        char c = hex[i];
+        DWORD64 v;
+        if (c >= '0' && c <= '9')
+            v = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            v = c - 'A' + 10;
+        else if (c == '-')
+            continue;
+        else
+            return FALSE;
+        if (digits == UUID_HEX_DIGITS)
+            return FALSE;
+        DWORD64 &half = digits < UUID_HEX_DIGITS / 2 ? Uuid.high : Uuid.low;
+        half = (half << 4) | v;
+        digits++;
+    }
+    return digits == UUID_HEX_DIGITS;
+}
+
+string UuidToHex(const CUuid &Uuid)
+{
+    string hex;
+    UuidToHex(Uuid, hex);
+    return hex;
+}
+
+void UuidToHex(const CUuid &Uuid, string &hex)
+{
+    static const char *pDigits = "0123456789abcdef";
+    hex.resize(UUID_HEX_DIGITS);
+    for (DWORD i = 0; i < UUID_HEX_DIGITS / 2; i++)
+    {
+        hex[i] = pDigits[(Uuid.high >> (60 - 4 * i)) & 0xF];
+        hex[UUID_HEX_DIGITS / 2 + i] = pDigits[(Uuid.low >> (60 - 4 * i)) & 0xF];
+    }
+}
+
+CUuid UuidFromName(const CUuid &Namespace, const BYTE *name, DWORD size)
+{
+    BYTE bytes[SHA1_BYTES];
+    UuidToBytes(Namespace, bytes);
+    CSha1 Sha1;
+    Sha1.Update(bytes, UUID_BYTES);
+    Sha1.Update(name, size);
+    Sha1.Final(bytes);
+    // The first bytes of the digest, with the version and the variant of RFC 4122
+    bytes[6] = (bytes[6] & 0x0F) | 0x50;
+    bytes[8] = (bytes[8] & 0x3F) | 0x80;
+    return UuidFromBytes(bytes);
+}
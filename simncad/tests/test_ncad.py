@@ -5,12 +5,18 @@
 import unittest
 import uuid
 import random
+import os
+import tempfile
+
+import numpy
 
 import simncad.ncad as ncw
 from simphony.cuds.particles import Particle, Bond, Particles
+from simphony.cuds.abc_particles import ABCParticles
 from simphony.core.data_container import DataContainer
 from simphony.core.cuba import CUBA
 from simncad.auxiliar.ncad_types import SHAPE_TYPE, SYMMETRY_GROUP
+from simncad.auxiliar import symmetry
 from simphony.core.cuds_item import CUDSItem
 import simphony.engine as engine_api
 from simphony.engine import EngineInterface, create_wrapper
@@ -231,6 +237,20 @@ class NCadWrapperTestCase(unittest.TestCase):
         for bond in assembly.iter_bonds():
             count += 1
 
+    def test_symmetry_numbers(self):
+        for number in range(1, 231):
+            name = symmetry.GetSymmetryHMByNumber(number)
+            self.assertEqual(symmetry.GetSymmetryNumberByHM(name), number)
+        # Blanks, the short monoclinic names and the origin choice may be
+        # omitted
+        self.assertEqual(symmetry.GetSymmetryNumberByHM('P 21/c'), 14)
+        self.assertEqual(symmetry.GetSymmetryNumberByHM('Pnnn'), 48)
+        self.assertEqual(symmetry.GetSymmetryNumberByHM('Ia-3d'), 230)
+        self.assertEqual(symmetry.GetSymmetryNumberByHM('X'), -1)
+        self.assertEqual(symmetry.GetSymmetryNumberByHM(None), -1)
+        self.assertEqual(symmetry.GetSymmetryHMByNumber(0), '')
+        self.assertEqual(symmetry.GetSymmetryHMByNumber(231), '')
+
     def test_update_particle_container(self):
         # cell
         cell_name = 'cell_pc' + str(random.random())
@@ -302,6 +322,493 @@ class NCadWrapperTestCase(unittest.TestCase):
         #                    (AXIS_TYPE.X,(1,1,0)))
 
 
+class NCadAssemblyTestCase(unittest.TestCase):
+    def setUp(self):
+        self.ncad = ncw.nCad(project='test_ncad' + str(random.random()))
+
+    def _add_cell(self, abc, atoms, bonds=()):
+        """Adds a P1 cell with atoms, given as (label, position) for carbon
+        or (label, position, specie), and bonds between the indexes of the
+        atoms. Returns the name."""
+        cell_name = 'cell_pc' + str(random.random())
+        cell = Particles(name=cell_name)
+        data = DataContainer()
+        data[CUBA.LATTICE_UC_ABC] = abc
+        data[CUBA.LATTICE_UC_ANGLES] = (90,90,90)
+        data[CUBA.SYMMETRY_GROUP] = SYMMETRY_GROUP.P1
+        cell.data = data
+        ncad_cell = self.ncad.add_dataset(cell)
+        uids = []
+        for atom in atoms:
+            particle = Particle(atom[1])
+            particle.data[CUBA.CHEMICAL_SPECIE] = atom[2] if len(atom) > 2 \
+                else 'C'
+            particle.data[CUBA.LABEL] = atom[0]
+            uids.extend(ncad_cell.add_particles([particle]))
+        if bonds:
+            ncad_cell.add_bonds([Bond((uids[i], uids[j])) for i, j in bonds])
+        return cell_name
+
+    def _add_component(self, cell_name, shape, center=(0, 0, 0), **kwargs):
+        """Adds a component of a cell, a block of kwargs['length'] cells or
+        a sphere of kwargs['radius']. Returns the nCad container."""
+        component = Particles(name='component_pc' + str(random.random()))
+        data = DataContainer()
+        data[CUBA.NAME_UC] = cell_name
+        data[CUBA.MATERIAL_TYPE] = shape
+        data[CUBA.SHAPE_CENTER] = center
+        if shape == SHAPE_TYPE.DIM_3D_BLOCK_UC:
+            data[CUBA.SHAPE_LENGTH_UC] = kwargs['length']
+        else:
+            data[CUBA.SHAPE_RADIUS] = kwargs['radius']
+        component.data = data
+        return self.ncad.add_dataset(component)
+
+    def _add_bonded_block(self):
+        """Adds a block of 2 x 2 x 2 cells of two bonded atoms."""
+        cell_name = self._add_cell((4,5,6), [('C1', (0, 0, 0)),
+                                             ('C2', (0.25, 0.25, 0.25))],
+                                   [(0, 1)])
+        return self._add_component(cell_name, SHAPE_TYPE.DIM_3D_BLOCK_UC,
+                                   length=(2, 2, 2))
+
+    def _add_cubic_block(self, length):
+        """Adds a block of length^3 cubic cells of edge 3 with an atom."""
+        cell_name = self._add_cell((3,3,3), [('C1', (0, 0, 0))])
+        return self._add_component(cell_name, SHAPE_TYPE.DIM_3D_BLOCK_UC,
+                                   length=(length, length, length))
+
+    def test_run_async(self):
+        cell_name = self._add_cell((4,5,6), [('C1', (0, 0, 0))])
+        self._add_component(cell_name, SHAPE_TYPE.DIM_3D_BLOCK_UC,
+                            length=(2, 2, 2))
+        job = self.ncad.run_async()
+        self.assertTrue(job.wait())
+        self.assertTrue(job.done())
+        self.assertTrue(job.wait(0))
+        assembly = job.result()
+        self.assertIs(job.result(), assembly)
+        self.assertEqual(len(list(assembly.iter_particles())), 8)
+        # A new job can start once the previous one is done
+        assembly = self.ncad.run_async().result()
+        self.assertEqual(len(list(assembly.iter_particles())), 8)
+
+    def test_run_async_busy(self):
+        # A large block keeps the job running for all the calls, which only
+        # check the job before doing anything
+        self._add_cubic_block(40)
+        handle, file_name = tempfile.mkstemp(suffix='.xyz')
+        os.close(handle)
+        calls = (self.ncad.run_arrays,
+                 lambda: next(self.ncad.iter_assembly_atoms()),
+                 lambda: next(self.ncad.iter_assembly_bonds()),
+                 lambda: self.ncad.export_xyz(file_name))
+        job = self.ncad.run_async()
+        busy_calls = 0
+        try:
+            for call in calls:
+                # A call made once the job is done succeeds, so it is skipped
+                if job.done():
+                    continue
+                with self.assertRaises(Exception) as context:
+                    call()
+                self.assertIn('already being processed',
+                              str(context.exception))
+                busy_calls += 1
+            self.assertEqual(job.result().count_of(CUDSItem.PARTICLE), 64000)
+            self.assertEqual(len(self.ncad.run_arrays()), 64000)
+            self.ncad.export_xyz(file_name)
+            with open(file_name) as xyz:
+                self.assertEqual(int(xyz.readline()), 64000)
+        finally:
+            os.remove(file_name)
+        if busy_calls == 0:
+            self.skipTest('The job ended before the calls')
+
+    def test_iter_assembly_open(self):
+        self._add_bonded_block()
+        atoms = self.ncad.iter_assembly_atoms(batch_size=5)
+        self.assertEqual(len(next(atoms)), 5)
+        # The cursor thread reads the assembly while the generator is
+        # suspended, so nCad can't process or read it meanwhile
+        self.assertRaises(Exception, self.ncad.run)
+        self.assertRaises(Exception, self.ncad.run_arrays)
+        self.assertRaises(Exception, self.ncad.run_async)
+        self.assertRaises(Exception, next, self.ncad.iter_assembly_bonds())
+        atoms.close()
+        self.assertEqual(len(self.ncad.run_arrays()), 16)
+        bonds = self.ncad.iter_assembly_bonds(batch_size=5)
+        next(bonds)
+        self.assertRaises(Exception, next, self.ncad.iter_assembly_atoms())
+        del bonds
+        self.assertEqual(
+            sum(len(batch) for batch in self.ncad.iter_assembly_atoms()), 16)
+
+    def test_run_parallel(self):
+        cell_name = self._add_cell((4,5,6), [('C1', (0, 0, 0))])
+        for i in xrange(3):
+            self._add_component(cell_name, SHAPE_TYPE.DIM_3D_SPHERE,
+                                center=(30 * i, 0, 0), radius=5.0 * (i + 1))
+        self.ncad.set_bond_max_length(6.1)
+        self.ncad.set_atom_order('morton')
+
+        def atoms(assembly):
+            return [(part.uid, tuple(part.coordinates),
+                     part.data[CUBA.CHEMICAL_SPECIE])
+                    for part in assembly.iter_particles()]
+        serial = sorted(atoms(self.ncad.run()))
+        serial_lazy = atoms(self.ncad.run(lazy=True))
+        serial_arrays = self.ncad.run_arrays()
+        self.ncad.set_workers(4)
+        parallel = sorted(atoms(self.ncad.run()))
+        parallel_lazy = atoms(self.ncad.run(lazy=True))
+        parallel_arrays = self.ncad.run_arrays()
+        # Same atoms, with the same uids, in the same order
+        self.assertTrue(serial)
+        self.assertEqual(serial, parallel)
+        self.assertEqual(serial_lazy, parallel_lazy)
+        self.assertEqual(list(serial_arrays.ids), list(parallel_arrays.ids))
+        self.assertEqual(list(serial_arrays.species),
+                         list(parallel_arrays.species))
+        self.assertEqual(serial_arrays.bonds.tolist(),
+                         parallel_arrays.bonds.tolist())
+
+    def test_run_uids(self):
+        cell_name = self._add_cell((4,5,6), [('C1', (0, 0, 0))])
+        self._add_component(cell_name, SHAPE_TYPE.DIM_3D_SPHERE, radius=10.0)
+        # The same assembly gets the same uids in the same namespace
+        assembly = self.ncad.run()
+        first = set(part.uid for part in assembly.iter_particles())
+        assembly = self.ncad.run()
+        second = set(part.uid for part in assembly.iter_particles())
+        self.assertEqual(first, second)
+        self.assertTrue(all(uid.version == 5 for uid in first))
+        self.ncad.set_uid_namespace(uuid.uuid4())
+        assembly = self.ncad.run()
+        third = set(part.uid for part in assembly.iter_particles())
+        self.assertEqual(len(third), len(first))
+        self.assertFalse(first & third)
+        snapshot = self.ncad.run_arrays()
+        self.assertEqual(set(uuid.UUID(bytes=uid.tostring())
+                             for uid in snapshot.uids), third)
+        self.assertRaises(TypeError, self.ncad.set_uid_namespace, 'ncad')
+
+    def test_run_again(self):
+        component = self._add_bonded_block()
+        first = self.ncad.run()
+        second = self.ncad.run()
+        # The atoms and bonds of the first run are replaced in the component,
+        # not added again nor processed as atoms of the component
+        for assembly in first, second:
+            self.assertEqual(assembly.count_of(CUDSItem.PARTICLE), 16)
+            self.assertEqual(assembly.count_of(CUDSItem.BOND), 8)
+        self.assertEqual(set(part.uid for part in first.iter_particles()),
+                         set(part.uid for part in second.iter_particles()))
+        self.assertEqual(set(bond.uid for bond in first.iter_bonds()),
+                         set(bond.uid for bond in second.iter_bonds()))
+        self.assertEqual(component.count_of(CUDSItem.PARTICLE), 16)
+        self.assertEqual(component.count_of(CUDSItem.BOND), 8)
+        for part in second.iter_particles():
+            self.assertTrue(component.has_particle(part.uid))
+        # Processing without run also takes them out of the component
+        self.assertEqual(len(self.ncad.run_arrays()), 16)
+        self.assertEqual(component.count_of(CUDSItem.PARTICLE), 0)
+
+    def test_uid_namespace(self):
+        self.assertEqual(self.ncad.get_uid_namespace(),
+                         uuid.uuid5(ncw.NCAD_NAMESPACE,
+                                    self.ncad.get_project_name()))
+
+    def test_run_bonds(self):
+        self._add_bonded_block()
+        assembly = self.ncad.run()
+        parts = dict((part.uid, part) for part in assembly.iter_particles())
+        bonds = list(assembly.iter_bonds())
+        self.assertEqual(len(bonds), 8)
+        # Each bond joins the C1 and C2 atoms of a cell, at 1, 1.25, 1.5
+        for bond in bonds:
+            first, second = [parts[uid] for uid in bond.particles]
+            self.assertEqual(
+                sorted([first.data[CUBA.LABEL], second.data[CUBA.LABEL]]),
+                ['C1', 'C2'])
+            distance = numpy.subtract(first.coordinates, second.coordinates)
+            self.assertAlmostEqual(numpy.linalg.norm(distance),
+                                   numpy.linalg.norm((1, 1.25, 1.5)))
+        self.assertEqual(
+            len(set(uid for bond in bonds for uid in bond.particles)), 16)
+        # The uids of the bonds are made from the uids of their atoms
+        namespace = self.ncad.get_uid_namespace()
+        for bond in bonds:
+            name = b''.join(sorted(uid.bytes for uid in bond.particles))
+            self.assertEqual(bond.uid, uuid.uuid5(namespace, name))
+
+    def test_run_bond_max_length(self):
+        self._add_cubic_block(3)
+        self.ncad.set_bond_max_length(3.1)
+        assembly = self.ncad.run()
+        coordinates = dict((part.uid, part.coordinates)
+                           for part in assembly.iter_particles())
+        self.assertEqual(len(coordinates), 27)
+        # Exactly the pairs of atoms closer than the maximal length, once
+        expected = set()
+        for first in coordinates:
+            for second in coordinates:
+                length = sum((a - b) ** 2 for a, b in
+                             zip(coordinates[first], coordinates[second]))
+                if first != second and length ** 0.5 <= 3.1:
+                    expected.add(frozenset((first, second)))
+        bonded = [frozenset(bond.particles)
+                  for bond in assembly.iter_bonds()]
+        self.assertEqual(len(bonded), 54)
+        self.assertEqual(len(set(bonded)), len(bonded))
+        self.assertEqual(set(bonded), expected)
+
+    def test_run_bond_max_length_cell_bonds(self):
+        self._add_bonded_block()
+        self.ncad.set_bond_max_length(3.7)
+        assembly = self.ncad.run()
+        coordinates = dict((part.uid, part.coordinates)
+                           for part in assembly.iter_particles())
+        # The pairs bonded by the cell are in range, but bonded once
+        expected = set()
+        for first in coordinates:
+            for second in coordinates:
+                length = sum((a - b) ** 2 for a, b in
+                             zip(coordinates[first], coordinates[second]))
+                if first != second and length ** 0.5 <= 3.7:
+                    expected.add(frozenset((first, second)))
+        bonded = [frozenset(bond.particles)
+                  for bond in assembly.iter_bonds()]
+        self.assertEqual(len(set(bonded)), len(bonded))
+        self.assertEqual(set(bonded), expected)
+        self.assertTrue(len(expected) > 8)
+
+    def test_autobond_cell(self):
+        cell_name = self._add_cell((4,5,6), [('C1', (0, 0, 0)),
+                                             ('C2', (0.25, 0.25, 0.25)),
+                                             ('C3', (0.5, 0.5, 0.5))])
+        self._add_component(cell_name, SHAPE_TYPE.DIM_3D_BLOCK_UC,
+                            length=(1, 1, 1))
+        # A second autobond does not repeat the bonds
+        self.ncad.autobond_cell(cell_name, 2.5)
+        self.ncad.autobond_cell(cell_name, 2.5)
+        assembly = self.ncad.run()
+        coordinates = dict((part.uid, part.coordinates)
+                           for part in assembly.iter_particles())
+        self.assertEqual(len(coordinates), 3)
+        expected = set()
+        for first in coordinates:
+            for second in coordinates:
+                length = sum((a - b) ** 2 for a, b in
+                             zip(coordinates[first], coordinates[second]))
+                if first != second and length ** 0.5 <= 2.5:
+                    expected.add(frozenset((first, second)))
+        bonded = [frozenset(bond.particles)
+                  for bond in assembly.iter_bonds()]
+        self.assertEqual(len(expected), 2)
+        self.assertEqual(len(bonded), len(expected))
+        self.assertEqual(set(bonded), expected)
+        self.assertRaises(Exception, self.ncad.autobond_cell, 'unknown', 2.5)
+
+    def test_run_atom_order(self):
+        self._add_cubic_block(4)
+        self.ncad.set_bond_max_length(3.1)
+        self.assertRaises(ValueError, self.ncad.set_atom_order, 'random')
+        self.ncad.set_atom_order('hilbert')
+        assembly = self.ncad.run()
+        self.assertEqual(len(list(assembly.iter_particles())), 64)
+        self.assertEqual(len(list(assembly.iter_bonds())), 144)
+        handle, file_name = tempfile.mkstemp(suffix='.xyz')
+        os.close(handle)
+        try:
+            self.ncad.export_xyz(file_name)
+            with open(file_name) as xyz:
+                lines = xyz.read().splitlines()
+        finally:
+            os.remove(file_name)
+        self.assertEqual(int(lines[0]), 64)
+        coordinates = [[float(v) for v in line.split()[1:]]
+                       for line in lines[2:]]
+        self.assertEqual(len(coordinates), 64)
+        # Consecutive atoms of the Hilbert curve are neighbours in the lattice
+        for first, second in zip(coordinates, coordinates[1:]):
+            length = sum((a - b) ** 2 for a, b in zip(first, second)) ** 0.5
+            self.assertAlmostEqual(length, 3)
+
+    def test_run_arrays(self):
+        component = self._add_cubic_block(4)
+        self.ncad.set_bond_max_length(3.1)
+        snapshot = self.ncad.run_arrays()
+        self.assertEqual(len(snapshot), 64)
+        self.assertEqual(snapshot.coordinates.shape, (64, 3))
+        self.assertEqual(snapshot.ids.shape, (64,))
+        self.assertEqual(snapshot.species_names, ['C'])
+        self.assertEqual(snapshot.label_names, ['C1'])
+        self.assertEqual(snapshot.component_names, [component.name])
+        self.assertEqual(set(snapshot.species), set([0]))
+        self.assertEqual(snapshot.bonds.shape, (144, 2))
+        self.assertFalse(snapshot.coordinates.flags.writeable)
+        first = snapshot.coordinates[snapshot.bonds[:, 0]]
+        second = snapshot.coordinates[snapshot.bonds[:, 1]]
+        lengths = ((first - second) ** 2).sum(axis=1) ** 0.5
+        for length in lengths:
+            self.assertAlmostEqual(length, 3)
+        particle = snapshot.get_particle(-1)
+        self.assertEqual(particle.uid, snapshot.get_particle(63).uid)
+        self.assertEqual(tuple(particle.coordinates),
+                         tuple(snapshot.coordinates[63]))
+        self.assertEqual(particle.data[CUBA.CHEMICAL_SPECIE], 'C')
+        self.assertEqual(particle.data[CUBA.OCCUPANCY],
+                         snapshot.occupancies[63])
+        self.assertRaises(IndexError, snapshot.get_particle, 64)
+        particles = list(snapshot.iter_particles())
+        self.assertEqual(len(particles), 64)
+        self.assertEqual([part.data[CUBA.OCCUPANCY] for part in particles],
+                         snapshot.occupancies.tolist())
+
+    def test_run_arrays_atoms(self):
+        self._add_bonded_block()
+        eager = dict((part.uid, part)
+                     for part in self.ncad.run().iter_particles())
+        snapshot = self.ncad.run_arrays()
+        self.assertEqual(len(snapshot), len(eager))
+        self.assertEqual(len(set(snapshot.ids)), len(eager))
+        # Every atom of the store has the data of the same atom of run
+        for i, uid in enumerate(snapshot.uids):
+            part = eager[uuid.UUID(bytes=uid.tostring())]
+            self.assertEqual(tuple(snapshot.coordinates[i]), part.coordinates)
+            self.assertEqual(snapshot.label_names[snapshot.labels[i]],
+                             part.data[CUBA.LABEL])
+            self.assertEqual(snapshot.occupancies[i],
+                             part.data[CUBA.OCCUPANCY])
+
+    def test_run_arrays_species(self):
+        cell_name = self._add_cell((4,5,6), [('Si1', (0, 0, 0), 'Si'),
+                                             ('O1', (0.25, 0.25, 0.25), 'O'),
+                                             ('O2', (0.5, 0.5, 0.5), 'O')])
+        self._add_component(cell_name, SHAPE_TYPE.DIM_3D_BLOCK_UC,
+                            length=(2, 2, 2))
+        eager = dict((part.uid, part)
+                     for part in self.ncad.run().iter_particles())
+        snapshot = self.ncad.run_arrays()
+        # Each name is stored once, and each atom keeps its code
+        self.assertEqual(sorted(snapshot.species_names), ['O', 'Si'])
+        self.assertEqual(sorted(snapshot.label_names), ['O1', 'O2', 'Si1'])
+        species = [snapshot.species_names[code] for code in snapshot.species]
+        self.assertEqual(species.count('Si'), 8)
+        self.assertEqual(species.count('O'), 16)
+        for i, uid in enumerate(snapshot.uids):
+            part = eager[uuid.UUID(bytes=uid.tostring())]
+            self.assertEqual(species[i], part.data[CUBA.CHEMICAL_SPECIE])
+            self.assertEqual(snapshot.label_names[snapshot.labels[i]],
+                             part.data[CUBA.LABEL])
+
+    def test_run_arrays_bonds(self):
+        self._add_bonded_block()
+        eager = self.ncad.run()
+        snapshot = self.ncad.run_arrays()
+        uids = [uuid.UUID(bytes=uid.tostring()) for uid in snapshot.uids]
+        # The bonds of the store are the bonds of run, each once
+        bonds = [frozenset((uids[first], uids[second]))
+                 for first, second in snapshot.bonds]
+        self.assertEqual(len(bonds), 8)
+        self.assertEqual(len(set(bonds)), len(bonds))
+        self.assertEqual(set(bonds), set(frozenset(bond.particles)
+                                         for bond in eager.iter_bonds()))
+        self.assertTrue(all(first < second
+                            for first, second in snapshot.bonds))
+
+    def test_run_arrays_find(self):
+        self._add_cubic_block(6)
+        snapshot = self.ncad.run_arrays()
+        xyz = snapshot.coordinates
+        # The grid finds the atoms found by testing each of them, faces and
+        # surface included, in the order of the arrays
+        lower, upper = (2.5, 3, -1), (9, 9, 6)
+        inside = numpy.all((xyz >= lower) & (xyz <= upper), axis=1)
+        self.assertEqual(snapshot.find_in_box(lower, upper).tolist(),
+                         numpy.nonzero(inside)[0].tolist())
+        for center, radius in (((6, 6, 6), 6), ((0, 0, 0), 4.5),
+                               ((7.5, 7.5, 7.5), 0.1)):
+            distance = numpy.sqrt(((xyz - center) ** 2).sum(axis=1))
+            self.assertEqual(
+                snapshot.find_in_radius(center, radius).tolist(),
+                numpy.nonzero(distance <= radius)[0].tolist())
+        self.assertEqual(len(snapshot.find_in_box((20, 20, 20),
+                                                  (30, 30, 30))), 0)
+
+    def test_run_component_index(self):
+        component = self._add_bonded_block()
+        assembly = self.ncad.run()
+        # The atoms and bonds that run adds to the component are found by
+        # uid, though they are not added through the index
+        uids = set(part.uid for part in assembly.iter_particles())
+        self.assertEqual(len(uids), 16)
+        self.assertEqual(set(part.uid for part in component.iter_particles()),
+                         uids)
+        for part in assembly.iter_particles():
+            self.assertTrue(component.has_particle(part.uid))
+            self.assertEqual(
+                component.get_particle(part.uid).data[CUBA.LABEL],
+                part.data[CUBA.LABEL])
+        for bond in assembly.iter_bonds():
+            self.assertTrue(component.has_bond(bond.uid))
+        self.assertFalse(component.has_particle(uuid.uuid4()))
+
+    def test_run_component_arrays(self):
+        component = self._add_bonded_block()
+        parts = list(self.ncad.run().iter_particles())
+        uids = ncw.uid_array([part.uid for part in parts])
+        # The bulk methods see the atoms that run adds to the component
+        (coordinates, species, species_names, labels, label_names,
+         occupancies) = component.get_particle_arrays(uids)
+        self.assertEqual(len(coordinates), 16)
+        for i, part in enumerate(parts):
+            self.assertEqual(species_names[species[i]],
+                             part.data[CUBA.CHEMICAL_SPECIE])
+            self.assertEqual(label_names[labels[i]], part.data[CUBA.LABEL])
+        component.remove_particle_arrays(uids[:6])
+        self.assertEqual(component.count_of(CUDSItem.PARTICLE), 10)
+        for i, part in enumerate(parts):
+            self.assertEqual(component.has_particle(part.uid), i >= 6)
+        with self.assertRaises(Exception):
+            component.get_particle_arrays(uids[:1])
+
+    def test_run_lazy(self):
+        self._add_bonded_block()
+        eager = self.ncad.run()
+        lazy = self.ncad.run(lazy=True)
+        self.assertIsInstance(lazy, ABCParticles)
+        self.assertEqual(lazy.count_of(CUDSItem.PARTICLE), 16)
+        self.assertEqual(lazy.count_of(CUDSItem.BOND),
+                         eager.count_of(CUDSItem.BOND))
+        # The atoms have the same uids of run
+        for part in eager.iter_particles():
+            self.assertTrue(lazy.has_particle(part.uid))
+            self.assertEqual(lazy.get_particle(part.uid).coordinates,
+                             part.coordinates)
+            self.assertEqual(lazy.get_particle(part.uid).data, part.data)
+        self.assertEqual(set(part.uid for part in lazy.iter_particles()),
+                         set(part.uid for part in eager.iter_particles()))
+        for bond in lazy.iter_bonds():
+            self.assertTrue(lazy.has_bond(bond.uid))
+            self.assertEqual(lazy.get_bond(bond.uid).particles,
+                             bond.particles)
+            for uid in bond.particles:
+                self.assertTrue(lazy.has_particle(uid))
+        # The bonds have the uids of run, made from the uids of their atoms
+        self.assertEqual(
+            dict((bond.uid, frozenset(bond.particles))
+                 for bond in lazy.iter_bonds()),
+            dict((bond.uid, frozenset(bond.particles))
+                 for bond in eager.iter_bonds()))
+        self.assertFalse(lazy.has_bond(uuid.uuid4()))
+        self.assertRaises(AttributeError, lazy.has_particle, 'uid')
+        self.assertFalse(lazy.has_particle(uuid.uuid4()))
+        self.assertRaises(KeyError, lazy.get_particle, uuid.uuid4())
+        self.assertRaises(Exception, lazy.add_particles, [Particle()])
+
+
 class NCadParticlesTestCase1(unittest.TestCase):
     def setUp(self):
         ncad_temp = ncw.nCad(project='test_ncad' + str(random.random()))
@@ -446,6 +953,42 @@ class NCadParticlesTestCase1(unittest.TestCase):
         with self.assertRaises(Exception):
             self.component.remove_particles([fake_id])
 
+    def test_particle_arrays(self):
+        coordinates = numpy.arange(30, dtype=float).reshape(10, 3)
+        species = [0, 1] * 5
+        uids = self.component.add_particle_arrays(coordinates, species,
+                                                  ['C', 'O'])
+        self.assertEqual(uids.shape, (10, 16))
+        for uid in uids:
+            self.assertTrue(self.component.has_particle(
+                uuid.UUID(bytes=uid.tostring())))
+        with self.assertRaises(Exception):
+            self.component.add_particle_arrays(coordinates[:1], [0], ['C'],
+                                               uids=uids[:1])
+        self.component.update_particle_arrays(uids[::2], -coordinates[::2],
+                                              [0] * 5, ['N'], [0] * 5, ['N1'])
+        (new_coordinates, new_species, species_names, labels, label_names,
+         occupancies) = self.component.get_particle_arrays(uids)
+        self.assertEqual(new_coordinates[0].tolist(), [0, -1, -2])
+        self.assertEqual(new_coordinates[1].tolist(), [3, 4, 5])
+        self.assertEqual(species_names[new_species[0]], 'N')
+        self.assertEqual(species_names[new_species[1]], 'O')
+        self.assertEqual(label_names[labels[0]], 'N1')
+        self.assertEqual(label_names[labels[1]], 'O')
+        self.assertEqual(occupancies.tolist(), [1] * 10)
+        particle = self.component.get_particle(
+            uuid.UUID(bytes=uids[3].tostring()))
+        self.assertEqual(particle.coordinates, (9, 10, 11))
+        self.component.remove_particle_arrays(uids[:5])
+        self.assertEqual(self.component.count_of(CUDSItem.PARTICLE), 5)
+        with self.assertRaises(Exception):
+            self.component.remove_particle_arrays(uids[4:])
+        self.assertEqual(self.component.count_of(CUDSItem.PARTICLE), 5)
+        # A uid repeated in the same call removes nothing either
+        with self.assertRaises(Exception):
+            self.component.remove_particle_arrays(uids[[5, 6, 5]])
+        self.assertEqual(self.component.count_of(CUDSItem.PARTICLE), 5)
+
     def test_iter_some_particles(self):
         # cell
         ids = []